@@ -0,0 +1,418 @@
+// Benchmark suite for the logger hot paths. Prints one JSON document to
+// stdout (progress goes to stderr), so runs can be archived and diffed
+// between releases:
+//
+//   bench_logger [--quick] [--out results.json]
+//
+// Sections:
+//   caller_latency  per-call cost of log_printf / RVLOG_* / RVLOG_*F on the
+//                   producer thread (p50/p99/p999/max), per queue mode
+//   throughput      end-to-end messages/s into a null sink vs producers
+//   format          to_json_line, append_json_line, iso8601_utc_ms
+//   file_sink       FileRotationSink and FileRotationAdapter write rates
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "rover_logger/FileRotationSink.h"
+#include "rover_logger/api.hpp"
+#include "rover_logger/file_rotation_adapter.hpp"
+#include "rover_logger/json_formatter.hpp"
+#include "rover_logger/logger.hpp"
+
+using namespace rover_logger;
+using Clock = std::chrono::steady_clock;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Params {
+  std::size_t latency_samples = 200000;
+  std::size_t throughput_msgs = 400000;  // total, split across producers
+  int format_iterations = 1000000;
+  std::size_t file_lines = 400000;
+};
+
+// Counts what the worker hands over and nothing else.
+class NullSink final : public rover_logger::ILogSink {
+ public:
+  void write(const LogMessage&) override {
+    count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void write_batch(const LogMessage*, std::size_t n) override {
+    count_.fetch_add(n, std::memory_order_relaxed);
+  }
+  std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<std::uint64_t> count_{0};
+};
+
+// Minimal JSON writer: objects/arrays of numbers and strings.
+class Json {
+ public:
+  Json& begin(const char* key = nullptr, char bracket = '{') {
+    sep(key);
+    out_ << bracket;
+    first_ = true;
+    return *this;
+  }
+  Json& end(char bracket = '}') {
+    out_ << bracket;
+    first_ = false;
+    return *this;
+  }
+  Json& num(const char* key, double v) {
+    sep(key);
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.10g", v);
+    out_ << buf;
+    return *this;
+  }
+  Json& str(const char* key, const std::string& v) {
+    sep(key);
+    out_ << '"' << json_escape(v) << '"';
+    return *this;
+  }
+  std::string text() const { return out_.str(); }
+
+ private:
+  void sep(const char* key) {
+    if (!first_) out_ << ',';
+    first_ = false;
+    if (key) out_ << '"' << key << "\":";
+  }
+
+  std::ostringstream out_;
+  bool first_ = true;
+};
+
+double elapsed_ns(Clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+double percentile(const std::vector<std::uint32_t>& sorted, double p) {
+  if (sorted.empty()) return 0;
+  const auto idx = static_cast<std::size_t>(p * (sorted.size() - 1));
+  return sorted[idx];
+}
+
+// Waits until the worker has handed everything accepted to the sinks.
+void drain(const Logger& logger, std::uint64_t produced) {
+  while (logger.processed_total() + logger.dropped_total() < produced) {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+}
+
+// ---------------------------------------------------------------------------
+// caller_latency
+// ---------------------------------------------------------------------------
+// Each call is timed individually with steady_clock, so the numbers
+// include ~20-30 ns of clock overhead. The queue holds every sample, so
+// this measures the enqueue path, not back-pressure from a full queue.
+template <class LogFn>
+void caller_latency(Json& js, const char* name, QueueMode mode,
+                    std::size_t samples, LogFn&& log_one) {
+  Logger logger(std::max<std::size_t>(samples, 4096), mode);
+  auto sink = std::make_shared<NullSink>();
+  logger.add_sink(sink);
+
+  std::vector<std::uint32_t> ns(samples);
+  for (std::size_t i = 0; i < samples; ++i) {
+    const auto t0 = Clock::now();
+    log_one(logger, static_cast<int>(i));
+    ns[i] = static_cast<std::uint32_t>(
+        std::min(elapsed_ns(t0), static_cast<double>(UINT32_MAX)));
+  }
+  drain(logger, samples);
+  std::sort(ns.begin(), ns.end());
+
+  js.begin()
+      .str("name", name)
+      .str("queue_mode", mode == QueueMode::Shared ? "shared" : "per_thread")
+      .num("samples", static_cast<double>(samples))
+      .num("p50_ns", percentile(ns, 0.50))
+      .num("p99_ns", percentile(ns, 0.99))
+      .num("p999_ns", percentile(ns, 0.999))
+      .num("max_ns", ns.back())
+      .num("dropped", static_cast<double>(logger.dropped_total()))
+      .end();
+  std::cerr << "caller_latency " << name << ": p50 " << percentile(ns, 0.5)
+            << " ns, p99 " << percentile(ns, 0.99) << " ns\n";
+}
+
+// ---------------------------------------------------------------------------
+// throughput
+// ---------------------------------------------------------------------------
+void throughput(Json& js, QueueMode mode, int producers, std::size_t total) {
+  const std::size_t per_thread = total / static_cast<std::size_t>(producers);
+  auto sink = std::make_shared<NullSink>();
+  double ns = 0;
+  std::uint64_t dropped = 0;
+  {
+    Logger logger(8192, mode);
+    logger.add_sink(sink);
+    const ModuleHandle mod("/bench/throughput");
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t) {
+      threads.emplace_back([&, t] {
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+        for (std::size_t i = 0; i < per_thread; ++i) {
+          log_printf(logger, LogLevel::INFO, mod, "producer %d seq %zu", t, i);
+        }
+      });
+    }
+    while (ready.load() != producers) std::this_thread::yield();
+
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) th.join();
+    drain(logger, per_thread * static_cast<std::size_t>(producers));
+    ns = elapsed_ns(start);
+    dropped = logger.dropped_total();
+  }
+
+  const double delivered = static_cast<double>(sink->count());
+  js.begin()
+      .str("queue_mode", mode == QueueMode::Shared ? "shared" : "per_thread")
+      .num("producers", producers)
+      .num("messages", static_cast<double>(per_thread * producers))
+      .num("delivered", delivered)
+      .num("dropped", static_cast<double>(dropped))
+      .num("seconds", ns / 1e9)
+      .num("delivered_per_sec", delivered / (ns / 1e9))
+      .end();
+  std::cerr << "throughput " << producers << "p: " << delivered / (ns / 1e9)
+            << " msg/s, dropped " << dropped << "\n";
+}
+
+// ---------------------------------------------------------------------------
+// format
+// ---------------------------------------------------------------------------
+template <class Fn>
+void format_case(Json& js, const char* name, int iterations, Fn&& fn) {
+  std::size_t checksum = 0;
+  const auto start = Clock::now();
+  for (int i = 0; i < iterations; ++i) checksum += fn(i);
+  const double ns = elapsed_ns(start) / iterations;
+  js.begin()
+      .str("name", name)
+      .num("iterations", iterations)
+      .num("ns_per_call", ns)
+      .num("checksum", static_cast<double>(checksum))
+      .end();
+  std::cerr << "format " << name << ": " << ns << " ns\n";
+}
+
+// ---------------------------------------------------------------------------
+// file_sink
+// ---------------------------------------------------------------------------
+void file_case(Json& js, const char* name, std::size_t lines, std::size_t bytes,
+               double ns) {
+  js.begin()
+      .str("name", name)
+      .num("lines", static_cast<double>(lines))
+      .num("bytes", static_cast<double>(bytes))
+      .num("lines_per_sec", lines / (ns / 1e9))
+      .num("mb_per_sec", bytes / (ns / 1e9) / 1e6)
+      .end();
+  std::cerr << "file_sink " << name << ": " << lines / (ns / 1e9)
+            << " lines/s\n";
+}
+
+std::uintmax_t remove_files(const fs::path& dir, const std::string& prefix) {
+  std::uintmax_t bytes = 0;
+  for (auto& e : fs::directory_iterator(dir)) {
+    if (e.path().filename().string().rfind(prefix, 0) != 0) continue;
+    bytes += e.file_size();
+    fs::remove(e.path());
+  }
+  return bytes;
+}
+
+std::string utc_now() {
+  const std::time_t t = std::time(nullptr);
+  std::tm tm{};
+  gmtime_r(&t, &tm);
+  char buf[32];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+  return buf;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Params p;
+  std::string out_path;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--quick") == 0) {
+      p.latency_samples = 20000;
+      p.throughput_msgs = 40000;
+      p.format_iterations = 100000;
+      p.file_lines = 40000;
+    } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      out_path = argv[++i];
+    } else {
+      std::cerr << "usage: bench_logger [--quick] [--out results.json]\n";
+      return 2;
+    }
+  }
+
+  Json js;
+  js.begin();
+  js.begin("meta")
+      .str("suite", "rover_logger")
+      .str("date", utc_now())
+#if defined(__clang__)
+      .str("compiler", "clang " __clang_version__)
+#elif defined(__GNUC__)
+      .str("compiler", "gcc " __VERSION__)
+#endif
+#ifdef NDEBUG
+      .str("build", "release")
+#else
+      .str("build", "debug")
+#endif
+      .num("hardware_threads", std::thread::hardware_concurrency())
+      .end();
+
+  // -- caller_latency -------------------------------------------------------
+  js.begin("caller_latency", '[');
+  for (QueueMode mode : {QueueMode::Shared, QueueMode::PerThread}) {
+    caller_latency(js, "log_printf", mode, p.latency_samples,
+                   [](Logger& lg, int i) {
+                     log_printf(lg, LogLevel::INFO, "/bench/latency",
+                                "pose x=%d y=%.2f", i, i * 0.5);
+                   });
+    const ModuleHandle mod("/bench/latency");
+    caller_latency(js, "log_printf_handle", mode, p.latency_samples,
+                   [mod](Logger& lg, int i) {
+                     log_printf(lg, LogLevel::INFO, mod, "pose x=%d y=%.2f", i,
+                                i * 0.5);
+                   });
+    caller_latency(js, "RVLOG_INFO", mode, p.latency_samples,
+                   [](Logger& lg, int i) {
+                     RVLOG_INFO(lg, "/bench/latency", "pose x=%d y=%.2f", i,
+                                i * 0.5);
+                   });
+    caller_latency(js, "RVLOG_INFOF", mode, p.latency_samples,
+                   [](Logger& lg, int i) {
+                     RVLOG_INFOF(lg, "/bench/latency", "pose x={} y={:.2f}", i,
+                                 i * 0.5);
+                   });
+  }
+  js.end(']');
+
+  // -- throughput -----------------------------------------------------------
+  js.begin("throughput", '[');
+  for (QueueMode mode : {QueueMode::Shared, QueueMode::PerThread}) {
+    for (int producers : {1, 2, 4, 8}) {
+      throughput(js, mode, producers, p.throughput_msgs);
+    }
+  }
+  js.end(']');
+
+  // -- format ---------------------------------------------------------------
+  js.begin("format", '[');
+  {
+    LogMessage msg(LogLevel::INFO, "/nav/planner",
+                   "replanned path around obstacle at x=12.5 y=-3.25");
+    const auto base = msg.ts;
+    format_case(js, "to_json_line", p.format_iterations, [&](int i) {
+      msg.ts = base + std::chrono::microseconds(2 * i);
+      return to_json_line(msg).size();
+    });
+    std::string line;
+    TimestampFormatter ts;
+    format_case(js, "append_json_line", p.format_iterations, [&](int i) {
+      msg.ts = base + std::chrono::microseconds(2 * i);
+      line.clear();
+      append_json_line(line, msg, ts);
+      return line.size();
+    });
+    format_case(js, "iso8601_utc_ms", p.format_iterations, [&](int i) {
+      return iso8601_utc_ms(base + std::chrono::microseconds(2 * i)).size();
+    });
+  }
+  js.end(']');
+
+  // -- file_sink ------------------------------------------------------------
+  js.begin("file_sink", '[');
+  {
+    const fs::path dir = fs::temp_directory_path() /
+                         ("rover_bench_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+    const std::size_t rotation = 64ull * 1024 * 1024;
+
+    const std::string line =
+        "{\"ts\":\"2025-01-01T00:00:00.000Z\",\"level\":\"INFO\",\"module\":"
+        "\"/nav/planner\",\"message\":\"replanned path around obstacle\"}";
+    {
+      const auto start = Clock::now();
+      {
+        FileRotationSink sink((dir / "raw").string(), rotation);
+        for (std::size_t i = 0; i < p.file_lines; ++i) sink.write(line);
+      }
+      const double ns = elapsed_ns(start);
+      file_case(js, "FileRotationSink::write", p.file_lines,
+                remove_files(dir, "raw_"), ns);
+    }
+
+    std::vector<LogMessage> batch;
+    for (int i = 0; i < 256; ++i) {
+      batch.emplace_back(LogLevel::INFO, "/nav/planner",
+                         "replanned path around obstacle, attempt " +
+                             std::to_string(i));
+    }
+    for (AdaptFormat format : {AdaptFormat::JSON, AdaptFormat::Binary}) {
+      FileRotationAdapterOptions opt;
+      opt.base_filename = (dir / "adapter").string();
+      opt.rotation_bytes = rotation;
+      opt.format = format;
+      const std::size_t rounds = p.file_lines / batch.size();
+      const auto start = Clock::now();
+      {
+        FileRotationAdapter adapter(opt);
+        for (std::size_t r = 0; r < rounds; ++r) {
+          adapter.write_batch(batch.data(), batch.size());
+        }
+      }
+      const double ns = elapsed_ns(start);
+      file_case(js,
+                format == AdaptFormat::JSON ? "FileRotationAdapter json batch"
+                                            : "FileRotationAdapter binary batch",
+                rounds * batch.size(), remove_files(dir, "adapter_"), ns);
+    }
+    fs::remove_all(dir);
+  }
+  js.end(']');
+
+  js.end();
+
+  const std::string text = js.text() + "\n";
+  if (out_path.empty()) {
+    std::cout << text;
+  } else {
+    std::ofstream(out_path) << text;
+    std::cerr << "wrote " << out_path << "\n";
+  }
+  return 0;
+}
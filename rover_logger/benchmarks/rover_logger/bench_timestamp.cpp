@@ -0,0 +1,87 @@
+// Micro-benchmark: cached TimestampFormatter vs the old ostringstream +
+// put_time formatter that to_json_line used for every message.
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "rover_logger/json_formatter.hpp"
+
+using namespace rover_logger;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// The previous iso8601_utc_ms, kept verbatim as the baseline.
+std::string legacy_iso8601_utc_ms(const LogMessage::clock::time_point& tp) {
+  using namespace std::chrono;
+  auto t = LogMessage::clock::to_time_t(tp);
+  std::tm tm{};
+  gmtime_r(&t, &tm);
+  auto ms = duration_cast<milliseconds>(tp.time_since_epoch()) % 1000;
+
+  std::ostringstream oss;
+  oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S") << '.' << std::setw(3)
+      << std::setfill('0') << ms.count() << 'Z';
+  return oss.str();
+}
+
+// Timestamps 2 us apart, i.e. a busy logger: ~500k lines per second.
+template <class Fn>
+double ns_per_call(const char* name, int iterations, Fn&& fn) {
+  const auto base = LogMessage::clock::now();
+  std::size_t sink = 0;
+  const auto start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    sink += fn(base + std::chrono::microseconds(2 * i));
+  }
+  const auto elapsed = Clock::now() - start;
+  const double ns =
+      std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+  std::cout << std::left << std::setw(28) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(1) << ns
+            << " ns/call  (checksum " << sink << ")\n";
+  return ns;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int iterations = argc > 1 ? std::stoi(argv[1]) : 2000000;
+
+  const double legacy = ns_per_call(
+      "legacy ostringstream", iterations,
+      [](auto tp) { return legacy_iso8601_utc_ms(tp).size(); });
+  const double cached = ns_per_call(
+      "iso8601_utc_ms (cached)", iterations,
+      [](auto tp) { return iso8601_utc_ms(tp).size(); });
+
+  std::string out;
+  TimestampFormatter ms(TimestampFormat::Iso8601Millis);
+  const double reused = ns_per_call("formatter, reused buffer", iterations,
+                                    [&](auto tp) {
+                                      out.clear();
+                                      ms.append(out, tp);
+                                      return out.size();
+                                    });
+  TimestampFormatter ns(TimestampFormat::Iso8601Nanos);
+  ns_per_call("formatter, iso8601_ns", iterations, [&](auto tp) {
+    out.clear();
+    ns.append(out, tp);
+    return out.size();
+  });
+  TimestampFormatter epoch(TimestampFormat::EpochMicros);
+  ns_per_call("formatter, epoch_us", iterations, [&](auto tp) {
+    out.clear();
+    epoch.append(out, tp);
+    return out.size();
+  });
+
+  std::cout << "speedup vs legacy: " << std::setprecision(1)
+            << legacy / cached << "x (string), " << legacy / reused
+            << "x (reused buffer)\n";
+  return 0;
+}
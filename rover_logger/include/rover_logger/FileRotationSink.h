@@ -1,24 +1,63 @@
 #ifndef FILEROTATIONSINK_H
 #define FILEROTATIONSINK_H
 
-#include <fstream>
+#include <cstddef>
+#include <functional>
 #include <string>
 
 #include "ILogSink.h"
 
+// Rotating file writer: base_0.log, base_1.log, ...
+//
+// Output is collected in a user-space buffer and only reaches the file when
+// the buffer fills, on rotation, or when flush()/sync() is called. The size
+// of the current file is tracked in memory (written + buffered bytes).
 class FileRotationSink : public ILogSink {
  private:
-  std::ofstream currentFile;
+  static constexpr size_t kDefaultBufferSize = 256 * 1024;
+
+  int fd;
   std::string baseFilename;
   size_t maxFileSize;
   int fileIndex;
+  size_t fileSize;    // bytes in the current file, including buffered ones
+  std::string buffer;
+  size_t bufferCapacity;
+  std::function<void(int)> onRotated;
 
+  std::string fileName(int index) const;
+  void openFile(bool truncate);
+  void closeFile();
   void rotate();
+  bool ensureOpen();
+  void append(const char* data, size_t len);
+  void writeAll(const char* data, size_t len);
 
  public:
-  FileRotationSink(const std::string& base, size_t maxSize);
+  FileRotationSink(const std::string& base, size_t maxSize,
+                   size_t bufferSize = kDefaultBufferSize);
   ~FileRotationSink();
+  FileRotationSink(const FileRotationSink&) = delete;
+  FileRotationSink& operator=(const FileRotationSink&) = delete;
+
   void write(const std::string& message) override;
+
+  // Writes a block of newline-terminated lines, rotating at line
+  // boundaries like write() does.
+  void writeBlock(const std::string& block);
+
+  // Writes one opaque record (no newline added), rotating after it once
+  // the file is full. Used for binary formats.
+  void writeRecord(const char* data, size_t len);
+
+  // Hands buffered bytes to the OS.
+  void flush();
+  // flush() plus fsync(): the data survives a power cut.
+  void sync();
+
+  // Called with the index of each file right after it has been closed by a
+  // rotation. Runs on the writing thread, so it must be cheap.
+  void setRotateCallback(std::function<void(int)> callback);
 };
 
-#endif  // FILEROTATIONSINK_H
\ No newline at end of file
+#endif  // FILEROTATIONSINK_H
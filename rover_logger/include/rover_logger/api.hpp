@@ -1,43 +1,374 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <type_traits>
 
+#include "rover_logger/deferred_format.hpp"
+#include "rover_logger/format.hpp"
 #include "rover_logger/log_level.hpp"
 #include "rover_logger/logger.hpp"
+#include "rover_logger/rate_limiter.hpp"
+
+// Statements below this level (0 = TRACE ... 5 = FATAL) are compiled out
+// entirely; their arguments are never evaluated.
+#ifndef ROVER_LOGGER_COMPILE_MIN_LEVEL
+#define ROVER_LOGGER_COMPILE_MIN_LEVEL 0
+#endif
+
+// When enabled (default), the RVLOG_* macros capture the format string and
+// arguments and leave the vsnprintf work to the logger's worker thread.
+// Build with -DROVER_LOGGER_DEFERRED_FORMAT=0 to format on the caller.
+#ifndef ROVER_LOGGER_DEFERRED_FORMAT
+#define ROVER_LOGGER_DEFERRED_FORMAT 1
+#endif
 
 namespace rover_logger {
 
+// Pre-check the RVLOG_* macros run before any argument is evaluated. A
+// resolved module (ModuleHandle) is checked against its cached level, plus
+// the flight recorder's level, which still wants filtered-out messages. A
+// module given by name only gets the global floor (level_enabled()):
+// resolving the name is left to the slow path.
+inline bool statement_enabled(const Logger& logger, LogLevel level,
+                              ModuleHandle module) {
+  return logger.should_log(level, module) || logger.recording(level);
+}
+template <class Name>
+bool statement_enabled(const Logger& logger, LogLevel level, const Name&) {
+  return logger.level_enabled(level);
+}
+
 // Core printf-style helper.
 // Example:
 //   log_printf(logger, LogLevel::INFO, "/drive", "Speed=%d", speed);
 void log_printf(Logger& logger, LogLevel level, const std::string& module,
                 const char* fmt, ...);
+// Same, with a pre-resolved module (no name lookup per call).
+void log_printf(Logger& logger, LogLevel level, ModuleHandle module,
+                const char* fmt, ...);
+
+// Deferred variant: copies fmt (which must be a string literal) and the
+// arguments into the message; the worker thread does the formatting.
+// Unsupported argument types are rejected at compile time.
+template <class... Args>
+void log_deferred(Logger& logger, LogLevel level, ModuleHandle module,
+                  const char* fmt, const Args&... args) {
+  const bool pass = logger.should_log(level, module);
+  if (!pass && !logger.recording(level)) return;
+
+  LogMessage msg{level, module.id()};
+  capture_deferred(msg, fmt, deferred_detail::decay_arg(args)...);
+  if (pass) {
+    logger.submit(std::move(msg));
+  } else {
+    logger.record(msg);  // flight recorder only
+  }
+}
+
+template <class... Args>
+void log_deferred(Logger& logger, LogLevel level, std::string_view module,
+                  const char* fmt, const Args&... args) {
+  log_deferred(logger, level, ModuleHandle(module), fmt, args...);
+}
+
+namespace printf_detail {
+// log_printf() takes C varargs: a std::string_view gets a NUL-terminated
+// copy (alive until the call returns), a scoped enum its underlying value.
+template <class T>
+decltype(auto) own(const T& v) {
+  if constexpr (std::is_same_v<T, std::string_view>) {
+    return std::string(v);
+  } else if constexpr (std::is_enum_v<T>) {
+    return static_cast<std::underlying_type_t<T>>(v);
+  } else {
+    return (v);
+  }
+}
+template <class T>
+const T& c_str(const T& v) {
+  return v;
+}
+inline const char* c_str(const std::string& s) { return s.c_str(); }
+}  // namespace printf_detail
+
+// Caller-side variant used with ROVER_LOGGER_DEFERRED_FORMAT=0: accepts
+// the same arguments as log_deferred() and converts string-like ones to
+// C strings before they reach log_printf()'s varargs.
+template <class... Args>
+void log_immediate(Logger& logger, LogLevel level, ModuleHandle module,
+                   const char* fmt, const Args&... args) {
+  static_assert(
+      (deferred_detail::is_capturable_v<std::decay_t<Args>> && ...),
+      "RVLOG_* arguments must be arithmetic, enum, pointer or string "
+      "(const char*, std::string, std::string_view) values");
+  log_printf(logger, level, module, fmt,
+             printf_detail::c_str(printf_detail::own(args))...);
+}
+
+template <class... Args>
+void log_immediate(Logger& logger, LogLevel level, std::string_view module,
+                   const char* fmt, const Args&... args) {
+  log_immediate(logger, level, ModuleHandle(module), fmt, args...);
+}
+
+// Type-safe variant behind RVLOG_*F: Fmt carries the format string (see
+// format_to()), the next argument is that same string and is ignored.
+// Formats on the caller, straight into the message.
+template <class Fmt, class FmtArg, class... Args>
+void log_format(Logger& logger, LogLevel level, ModuleHandle module,
+                const FmtArg&, const Args&... args) {
+  const bool pass = logger.should_log(level, module);
+  if (!pass && !logger.recording(level)) return;
+
+  LogMessage msg{level, module.id()};
+  format_to<Fmt>(msg.text, args...);
+  if (pass) {
+    logger.submit(std::move(msg));
+  } else {
+    logger.record(msg);  // flight recorder only
+  }
+}
+
+template <class Fmt, class FmtArg, class... Args>
+void log_format(Logger& logger, LogLevel level, std::string_view module,
+                const FmtArg& fmt, const Args&... args) {
+  log_format<Fmt>(logger, level, ModuleHandle(module), fmt, args...);
+}
 
 }  // namespace rover_logger
 
 // Public one-line macros – *this* is what subsystems will use.
 // These satisfy "one-line interface", "per-log config", and
 // "printf-like formatting" requirements.
+//
+// In deferred mode the format string must be a literal: the leading ""
+// makes anything else a compile error, since only the pointer is queued.
+//
+// RVLOG_<LEVEL>_EVERY_N(logger, module, n, fmt, ...) logs the 1st, (n+1)th,
+// ... pass through that statement; RVLOG_<LEVEL>_EVERY_SEC(logger, module,
+// seconds, fmt, ...) at most once per period. Each statement keeps its own
+// counters. (FATAL has no such variants.)
+//
+// RVLOG_<LEVEL>F(logger, module, fmt, ...) takes a {}-style format string
+// instead (format.hpp), checked against the argument types at compile time
+// and formatted on the caller without going through vsnprintf:
+//   RVLOG_INFOF(logger, kDrive, "speed={:.2f} m/s after {}", v, dt);
+
+#if ROVER_LOGGER_DEFERRED_FORMAT
+#define ROVER_LOGGER_EMIT_(logger, level, module, ...)                       \
+  ::rover_logger::log_deferred((logger), (level), (module), "" __VA_ARGS__)
+#else
+#define ROVER_LOGGER_EMIT_(logger, level, module, ...)                       \
+  ::rover_logger::log_immediate((logger), (level), (module), __VA_ARGS__)
+#endif
+
+// Runtime early-out: statement_enabled() is checked before any argument is
+// evaluated, so with a ModuleHandle a statement disabled for that module
+// costs a few relaxed loads and a branch.
+#define ROVER_LOGGER_LOG_(logger, level, module, ...)                        \
+  do {                                                                       \
+    auto& rvlog_logger_ = (logger);                                          \
+    auto&& rvlog_module_ = (module);                                         \
+    if (::rover_logger::statement_enabled(rvlog_logger_, level,              \
+                                          rvlog_module_)) {                  \
+      ROVER_LOGGER_EMIT_(rvlog_logger_, level, rvlog_module_, __VA_ARGS__);  \
+    }                                                                        \
+  } while (0)
+
+// Per-call-site limited statement: rvlog_site_.admit decides, and what it
+// held back is reported after a statement that gets through (at most once
+// a second) as "suppressed N similar messages".
+#define ROVER_LOGGER_LOG_LIMITED_(logger, level, module, admit, ...)         \
+  do {                                                                       \
+    auto& rvlog_logger_ = (logger);                                          \
+    auto&& rvlog_module_ = (module);                                         \
+    if (::rover_logger::statement_enabled(rvlog_logger_, level,              \
+                                          rvlog_module_)) {                  \
+      static ::rover_logger::CallSiteLimiter rvlog_site_;                    \
+      if (rvlog_site_.admit) {                                               \
+        ROVER_LOGGER_EMIT_(rvlog_logger_, level, rvlog_module_, __VA_ARGS__); \
+        if (const auto rvlog_n_ = rvlog_site_.take_suppressed()) {           \
+          ROVER_LOGGER_EMIT_(rvlog_logger_, level, rvlog_module_,            \
+                             "suppressed %llu similar messages",             \
+                             static_cast<unsigned long long>(rvlog_n_));     \
+        }                                                                    \
+      }                                                                      \
+    }                                                                        \
+  } while (0)
+
+// Type-safe statement: the format string (first of the variadic arguments)
+// becomes a per-statement type, so format_to() can parse and check it
+// against the arguments at compile time. It must be a literal.
+#define ROVER_LOGGER_FIRST_(first, ...) first
+#define ROVER_LOGGER_LOGF_(logger, level, module, ...)                       \
+  do {                                                                       \
+    auto& rvlog_logger_ = (logger);                                          \
+    auto&& rvlog_module_ = (module);                                         \
+    if (::rover_logger::statement_enabled(rvlog_logger_, level,              \
+                                          rvlog_module_)) {                  \
+      struct rvlog_fmt_ {                                                    \
+        static constexpr std::string_view str() {                            \
+          return ROVER_LOGGER_FIRST_(__VA_ARGS__, 0);                        \
+        }                                                                    \
+      };                                                                     \
+      ::rover_logger::log_format<rvlog_fmt_>(rvlog_logger_, (level),         \
+                                             rvlog_module_, __VA_ARGS__);    \
+    }                                                                        \
+  } while (0)
+
+// Compiled-out statement: still type-checked (unevaluated) so variables
+// used only in logging don't trigger unused warnings, but emits no code.
+#define ROVER_LOGGER_ELIDE_(logger, level, module, ...)                      \
+  ((void)sizeof((ROVER_LOGGER_EMIT_(logger, level, module, __VA_ARGS__), 0)))
+#define ROVER_LOGGER_ELIDEF_(logger, level, module, ...)                     \
+  do {                                                                       \
+    if (false) ROVER_LOGGER_LOGF_(logger, level, module, __VA_ARGS__);       \
+  } while (0)
 
-#define RVLOG_TRACE(logger, module, ...)                                \
-  ::rover_logger::log_printf((logger), ::rover_logger::LogLevel::TRACE, \
-                             (module), __VA_ARGS__)
+#if ROVER_LOGGER_COMPILE_MIN_LEVEL <= 0
+#define RVLOG_TRACE(logger, module, ...)                                     \
+  ROVER_LOGGER_LOG_(logger, ::rover_logger::LogLevel::TRACE, module,         \
+                    __VA_ARGS__)
+#define RVLOG_TRACEF(logger, module, ...)                                    \
+  ROVER_LOGGER_LOGF_(logger, ::rover_logger::LogLevel::TRACE, module,        \
+                     __VA_ARGS__)
+#define RVLOG_TRACE_EVERY_N(logger, module, n, ...)                          \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::TRACE, module, \
+                            every_n(n), __VA_ARGS__)
+#define RVLOG_TRACE_EVERY_SEC(logger, module, seconds, ...)                  \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::TRACE, module, \
+                            every(seconds), __VA_ARGS__)
+#else
+#define RVLOG_TRACE(logger, module, ...)                                     \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::TRACE, module,       \
+                      __VA_ARGS__)
+#define RVLOG_TRACEF(logger, module, ...)                                    \
+  ROVER_LOGGER_ELIDEF_(logger, ::rover_logger::LogLevel::TRACE, module,      \
+                       __VA_ARGS__)
+#define RVLOG_TRACE_EVERY_N(logger, module, n, ...)                          \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::TRACE, module,       \
+                      __VA_ARGS__)
+#define RVLOG_TRACE_EVERY_SEC(logger, module, seconds, ...)                  \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::TRACE, module,       \
+                      __VA_ARGS__)
+#endif
 
-#define RVLOG_DEBUG(logger, module, ...)                                \
-  ::rover_logger::log_printf((logger), ::rover_logger::LogLevel::DEBUG, \
-                             (module), __VA_ARGS__)
+#if ROVER_LOGGER_COMPILE_MIN_LEVEL <= 1
+#define RVLOG_DEBUG(logger, module, ...)                                     \
+  ROVER_LOGGER_LOG_(logger, ::rover_logger::LogLevel::DEBUG, module,         \
+                    __VA_ARGS__)
+#define RVLOG_DEBUGF(logger, module, ...)                                    \
+  ROVER_LOGGER_LOGF_(logger, ::rover_logger::LogLevel::DEBUG, module,        \
+                     __VA_ARGS__)
+#define RVLOG_DEBUG_EVERY_N(logger, module, n, ...)                          \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::DEBUG, module, \
+                            every_n(n), __VA_ARGS__)
+#define RVLOG_DEBUG_EVERY_SEC(logger, module, seconds, ...)                  \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::DEBUG, module, \
+                            every(seconds), __VA_ARGS__)
+#else
+#define RVLOG_DEBUG(logger, module, ...)                                     \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::DEBUG, module,       \
+                      __VA_ARGS__)
+#define RVLOG_DEBUGF(logger, module, ...)                                    \
+  ROVER_LOGGER_ELIDEF_(logger, ::rover_logger::LogLevel::DEBUG, module,      \
+                       __VA_ARGS__)
+#define RVLOG_DEBUG_EVERY_N(logger, module, n, ...)                          \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::DEBUG, module,       \
+                      __VA_ARGS__)
+#define RVLOG_DEBUG_EVERY_SEC(logger, module, seconds, ...)                  \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::DEBUG, module,       \
+                      __VA_ARGS__)
+#endif
 
-#define RVLOG_INFO(logger, module, ...)                                \
-  ::rover_logger::log_printf((logger), ::rover_logger::LogLevel::INFO, \
-                             (module), __VA_ARGS__)
+#if ROVER_LOGGER_COMPILE_MIN_LEVEL <= 2
+#define RVLOG_INFO(logger, module, ...)                                      \
+  ROVER_LOGGER_LOG_(logger, ::rover_logger::LogLevel::INFO, module,          \
+                    __VA_ARGS__)
+#define RVLOG_INFOF(logger, module, ...)                                     \
+  ROVER_LOGGER_LOGF_(logger, ::rover_logger::LogLevel::INFO, module,         \
+                     __VA_ARGS__)
+#define RVLOG_INFO_EVERY_N(logger, module, n, ...)                           \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::INFO, module,  \
+                            every_n(n), __VA_ARGS__)
+#define RVLOG_INFO_EVERY_SEC(logger, module, seconds, ...)                   \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::INFO, module,  \
+                            every(seconds), __VA_ARGS__)
+#else
+#define RVLOG_INFO(logger, module, ...)                                      \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::INFO, module,        \
+                      __VA_ARGS__)
+#define RVLOG_INFOF(logger, module, ...)                                     \
+  ROVER_LOGGER_ELIDEF_(logger, ::rover_logger::LogLevel::INFO, module,       \
+                       __VA_ARGS__)
+#define RVLOG_INFO_EVERY_N(logger, module, n, ...)                           \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::INFO, module,        \
+                      __VA_ARGS__)
+#define RVLOG_INFO_EVERY_SEC(logger, module, seconds, ...)                   \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::INFO, module,        \
+                      __VA_ARGS__)
+#endif
 
-#define RVLOG_WARN(logger, module, ...)                                \
-  ::rover_logger::log_printf((logger), ::rover_logger::LogLevel::WARN, \
-                             (module), __VA_ARGS__)
+#if ROVER_LOGGER_COMPILE_MIN_LEVEL <= 3
+#define RVLOG_WARN(logger, module, ...)                                      \
+  ROVER_LOGGER_LOG_(logger, ::rover_logger::LogLevel::WARN, module,          \
+                    __VA_ARGS__)
+#define RVLOG_WARNF(logger, module, ...)                                     \
+  ROVER_LOGGER_LOGF_(logger, ::rover_logger::LogLevel::WARN, module,         \
+                     __VA_ARGS__)
+#define RVLOG_WARN_EVERY_N(logger, module, n, ...)                           \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::WARN, module,  \
+                            every_n(n), __VA_ARGS__)
+#define RVLOG_WARN_EVERY_SEC(logger, module, seconds, ...)                   \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::WARN, module,  \
+                            every(seconds), __VA_ARGS__)
+#else
+#define RVLOG_WARN(logger, module, ...)                                      \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::WARN, module,        \
+                      __VA_ARGS__)
+#define RVLOG_WARNF(logger, module, ...)                                     \
+  ROVER_LOGGER_ELIDEF_(logger, ::rover_logger::LogLevel::WARN, module,       \
+                       __VA_ARGS__)
+#define RVLOG_WARN_EVERY_N(logger, module, n, ...)                           \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::WARN, module,        \
+                      __VA_ARGS__)
+#define RVLOG_WARN_EVERY_SEC(logger, module, seconds, ...)                   \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::WARN, module,        \
+                      __VA_ARGS__)
+#endif
 
-#define RVLOG_ERROR(logger, module, ...)                                \
-  ::rover_logger::log_printf((logger), ::rover_logger::LogLevel::ERROR, \
-                             (module), __VA_ARGS__)
+#if ROVER_LOGGER_COMPILE_MIN_LEVEL <= 4
+#define RVLOG_ERROR(logger, module, ...)                                     \
+  ROVER_LOGGER_LOG_(logger, ::rover_logger::LogLevel::ERROR, module,         \
+                    __VA_ARGS__)
+#define RVLOG_ERRORF(logger, module, ...)                                    \
+  ROVER_LOGGER_LOGF_(logger, ::rover_logger::LogLevel::ERROR, module,        \
+                     __VA_ARGS__)
+#define RVLOG_ERROR_EVERY_N(logger, module, n, ...)                          \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::ERROR, module, \
+                            every_n(n), __VA_ARGS__)
+#define RVLOG_ERROR_EVERY_SEC(logger, module, seconds, ...)                  \
+  ROVER_LOGGER_LOG_LIMITED_(logger, ::rover_logger::LogLevel::ERROR, module, \
+                            every(seconds), __VA_ARGS__)
+#else
+#define RVLOG_ERROR(logger, module, ...)                                     \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::ERROR, module,       \
+                      __VA_ARGS__)
+#define RVLOG_ERRORF(logger, module, ...)                                    \
+  ROVER_LOGGER_ELIDEF_(logger, ::rover_logger::LogLevel::ERROR, module,      \
+                       __VA_ARGS__)
+#define RVLOG_ERROR_EVERY_N(logger, module, n, ...)                          \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::ERROR, module,       \
+                      __VA_ARGS__)
+#define RVLOG_ERROR_EVERY_SEC(logger, module, seconds, ...)                  \
+  ROVER_LOGGER_ELIDE_(logger, ::rover_logger::LogLevel::ERROR, module,       \
+                      __VA_ARGS__)
+#endif
 
-#define RVLOG_FATAL(logger, module, ...)                                \
-  ::rover_logger::log_printf((logger), ::rover_logger::LogLevel::FATAL, \
-                             (module), __VA_ARGS__)
+// FATAL is never compiled out.
+#define RVLOG_FATAL(logger, module, ...)                                     \
+  ROVER_LOGGER_LOG_(logger, ::rover_logger::LogLevel::FATAL, module,         \
+                    __VA_ARGS__)
+#define RVLOG_FATALF(logger, module, ...)                                    \
+  ROVER_LOGGER_LOGF_(logger, ::rover_logger::LogLevel::FATAL, module,        \
+                     __VA_ARGS__)
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "rover_logger/log_level.hpp"
+#include "rover_logger/log_message.hpp"
+#include "rover_logger/module_registry.hpp"
+
+namespace rover_logger {
+
+// Compact binary log files.
+//
+// A file is a sequence of length-prefixed records, starting with a header
+// record:
+//
+//   record:  varint body_len, body
+//   body:    0x00 header "RVLB" u8 version u8 flags (always first)
+//            0x01 log    zigzag-varint ts delta (ns, vs. previous log
+//                        record in the file), u8 level, varint module id,
+//                        raw text (rest of the body)
+//            0x02 module varint module id, name (rest of the body)
+//
+// A module record is written the first time an id appears in a file, so
+// every file can be decoded on its own, and files can be concatenated
+// (a header record resets the decoder). Unknown record types are skipped.
+// No body is longer than kMaxRecordBytes; the encoder cuts longer text.
+namespace binary_format {
+inline constexpr char kMagic[4] = {'R', 'V', 'L', 'B'};
+inline constexpr std::uint8_t kVersion = 1;
+inline constexpr std::uint8_t kHeaderRecord = 0x00;
+inline constexpr std::uint8_t kLogRecord = 0x01;
+inline constexpr std::uint8_t kModuleRecord = 0x02;
+inline constexpr std::size_t kMaxRecordBytes = 16u << 20;
+}  // namespace binary_format
+
+class BinaryLogEncoder {
+ public:
+  // Starts a new file: writes the header record and forgets the previous
+  // file's timestamp base and module dictionary.
+  void begin_file(std::string& out);
+
+  // Appends msg (preceded by a module record if needed).
+  void append(std::string& out, const LogMessage& msg);
+
+ private:
+  std::int64_t last_ts_ns_ = 0;
+  std::vector<bool> modules_written_ =
+      std::vector<bool>(ModuleRegistry::kMaxModules, false);
+  std::string body_;  // scratch
+};
+
+struct DecodedRecord {
+  std::int64_t ts_ns = 0;  // since the Unix epoch
+  LogLevel level = LogLevel::INFO;
+  std::string_view module;  // valid until the next call to next()
+  std::string_view text;    // valid until the next call to next()
+};
+
+// Streams records back out of one or more concatenated binary files.
+class BinaryLogDecoder {
+ public:
+  enum class Status { Record, End, Corrupt };
+
+  explicit BinaryLogDecoder(std::istream& in) : in_(in) {}
+
+  Status next(DecodedRecord& out);
+  const std::string& error() const { return error_; }
+
+ private:
+  bool read_header(const char* p, const char* end);
+
+  std::istream& in_;
+  bool in_file_ = false;  // a header has been seen
+  std::int64_t last_ts_ns_ = 0;
+  std::unordered_map<std::uint64_t, std::string> modules_;
+  std::string body_;
+  std::string error_;
+};
+
+}  // namespace rover_logger
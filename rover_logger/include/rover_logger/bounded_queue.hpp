@@ -0,0 +1,363 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace rover_logger {
+
+// Keeps producer and consumer indices on separate cache lines so they don't
+// false-share.
+inline constexpr std::size_t kCacheLineSize = 64;
+
+// Wake-up channel for an idle consumer.
+//
+// Producers only pay for the mutex + notify when the consumer has announced
+// it is about to sleep; otherwise ring() is a fence and a single load.
+class Doorbell {
+ public:
+  // Called by producers after publishing an item.
+  void ring() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!sleeping_.load(std::memory_order_relaxed)) return;
+    wake_all();
+  }
+
+  // Unconditional wake-up (used for stop requests).
+  void wake_all() {
+    { std::scoped_lock lk(m_); }
+    cv_.notify_all();
+  }
+
+  // Blocks the consumer until ready() is true.
+  template <class Ready>
+  void wait(Ready ready) {
+    std::unique_lock lk(m_);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!ready()) cv_.wait(lk);
+    sleeping_.store(false, std::memory_order_relaxed);
+  }
+
+  // As wait(), but gives up at deadline. Returns the final ready() value.
+  template <class Ready, class Clock, class Duration>
+  bool wait_until(Ready ready,
+                  const std::chrono::time_point<Clock, Duration>& deadline) {
+    std::unique_lock lk(m_);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool ok = ready();
+    while (!ok) {
+      const bool timed_out =
+          cv_.wait_until(lk, deadline) == std::cv_status::timeout;
+      ok = ready();
+      if (timed_out) break;
+    }
+    sleeping_.store(false, std::memory_order_relaxed);
+    return ok;
+  }
+
+ private:
+  std::mutex m_;
+  std::condition_variable cv_;
+  std::atomic<bool> sleeping_{false};
+};
+
+// Bounded lock-free multi-producer / single-consumer ring. On overflow the
+// producer picks: evict the oldest (push_drop_oldest), give up
+// (push_if_space) or wait for room (push_wait).
+//
+// Slots carry a sequence number (Vyukov-style), so producers only contend on
+// the tail index. When the ring is full a producer evicts the oldest entry
+// itself, which is why the pop side tolerates concurrent callers.
+//
+// Several queues may share one Doorbell so a single consumer can sleep on
+// all of them at once (see Logger's per-thread mode).
+template <class T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(std::size_t cap, Doorbell* bell = nullptr)
+      : cap_(cap == 0 ? 1 : cap),
+        cells_(new Cell[cap_]),
+        bell_(bell != nullptr ? bell : &own_bell_) {
+    for (std::size_t i = 0; i < cap_; ++i) {
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~BoundedQueue() {
+    while (discard_one()) {
+    }
+  }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  // Pushes an item; if full, drops the oldest.
+  // Returns the number of items dropped to make room (normally 0 or 1).
+  std::size_t push_drop_oldest(T&& item) {
+    return push_drop_oldest(std::move(item), [](const T&) {});
+  }
+
+  // As above; on_evict(const T&) sees each evicted item before it is
+  // destroyed (e.g. to count drops by severity).
+  template <class OnEvict>
+  std::size_t push_drop_oldest(T&& item, OnEvict&& on_evict) {
+    std::size_t dropped = 0;
+    while (!try_push(item)) {
+      if (pop_with([&](T& old) { on_evict(static_cast<const T&>(old)); })) {
+        ++dropped;
+      }
+    }
+    published();
+    return dropped;
+  }
+
+  // Pushes only if there is room; a full queue leaves item untouched and
+  // returns false ("drop newest" is then up to the caller).
+  bool push_if_space(T& item) {
+    if (!try_push(item)) return false;
+    published();
+    return true;
+  }
+
+  // Waits up to timeout for room (timeout < 0: until stop is requested).
+  // False if the queue was still full, or stop was requested, in which
+  // case item is left untouched. The uncontended path is push_if_space().
+  bool push_wait(T& item, std::chrono::microseconds timeout) {
+    if (push_if_space(item)) return true;
+
+    using clock = std::chrono::steady_clock;
+    const bool bounded = timeout >= std::chrono::microseconds::zero();
+    const auto deadline = clock::now() + timeout;
+    bool ok = false;
+    space_waiters_.fetch_add(1, std::memory_order_seq_cst);
+    for (;;) {
+      if (try_push(item)) {
+        ok = true;
+        break;
+      }
+      if (stop_.load(std::memory_order_acquire)) break;
+      const auto now = clock::now();
+      if (bounded && now >= deadline) break;
+      // Short slices: a pop racing with our registration can miss the
+      // notify, which then costs at most one slice.
+      auto until = now + std::chrono::milliseconds(1);
+      if (bounded && deadline < until) until = deadline;
+      std::unique_lock lk(space_m_);
+      space_cv_.wait_until(lk, until, [&] {
+        return size() < cap_ || stop_.load(std::memory_order_acquire);
+      });
+    }
+    space_waiters_.fetch_sub(1, std::memory_order_relaxed);
+    if (ok) published();
+    return ok;
+  }
+
+  // Non-blocking pop. Returns false if the queue is empty.
+  bool try_pop(T& out) {
+    return pop_with([&](T& item) { out = std::move(item); });
+  }
+
+  // Appends up to max items to out without waiting; returns how many.
+  std::size_t try_pop_batch(std::vector<T>& out, std::size_t max) {
+    std::size_t n = 0;
+    while (n < max &&
+           pop_with([&](T& item) { out.push_back(std::move(item)); })) {
+      ++n;
+    }
+    return n;
+  }
+
+  // Blocks until an item is available or stop is requested.
+  bool pop_wait(T& out) {
+    for (;;) {
+      if (try_pop(out)) return true;
+      if (stop_.load(std::memory_order_acquire)) return try_pop(out);
+      bell_->wait([&] {
+        return !empty() || stop_.load(std::memory_order_acquire);
+      });
+    }
+  }
+
+  // Blocks until at least one item is available (or stop is requested),
+  // then appends up to max items to out. If linger is non-zero and the
+  // batch is not full, keeps collecting for up to linger before returning.
+  // A non-zero max_idle bounds the wait for the first item; on timeout it
+  // returns true with nothing appended.
+  // Returns false only when stopped and empty.
+  bool pop_wait_batch(std::vector<T>& out, std::size_t max,
+                      std::chrono::microseconds linger =
+                          std::chrono::microseconds::zero(),
+                      std::chrono::microseconds max_idle =
+                          std::chrono::microseconds::zero()) {
+    const std::size_t start = out.size();
+    if (max == 0) max = 1;
+    auto drain = [&] {
+      while (out.size() - start < max &&
+             pop_with([&](T& item) { out.push_back(std::move(item)); })) {
+      }
+    };
+
+    const auto ready = [&] {
+      return !empty() || stop_.load(std::memory_order_acquire);
+    };
+    for (;;) {
+      drain();
+      if (out.size() > start) break;
+      if (stop_.load(std::memory_order_acquire)) {
+        drain();
+        return out.size() > start;
+      }
+      if (max_idle > std::chrono::microseconds::zero()) {
+        if (!bell_->wait_until(ready,
+                               std::chrono::steady_clock::now() + max_idle)) {
+          return true;  // idle timeout
+        }
+      } else {
+        bell_->wait(ready);
+      }
+    }
+
+    if (linger > std::chrono::microseconds::zero() &&
+        out.size() - start < max) {
+      const auto deadline = std::chrono::steady_clock::now() + linger;
+      while (out.size() - start < max &&
+             !stop_.load(std::memory_order_acquire) &&
+             bell_->wait_until(ready, deadline)) {
+        drain();
+      }
+    }
+    return true;
+  }
+
+  void request_stop() {
+    stop_.store(true, std::memory_order_release);
+    bell_->wake_all();
+    notify_space();
+  }
+
+  // True if no published item is waiting at the front. Only a hint while
+  // producers are active.
+  bool empty() const {
+    const std::size_t pos = head_.load(std::memory_order_relaxed);
+    return cells_[pos % cap_].seq.load(std::memory_order_acquire) != pos + 1;
+  }
+
+  // Items currently queued. Only a hint while producers are active.
+  std::size_t size() const {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t n = tail > head ? tail - head : 0;
+    return n > cap_ ? cap_ : n;
+  }
+
+  std::size_t peak() const { return peak_.load(std::memory_order_relaxed); }
+
+  std::size_t capacity() const { return cap_; }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> seq;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* item() { return std::launder(reinterpret_cast<T*>(storage)); }
+  };
+
+  bool try_push(T& item) {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& c = cells_[pos % cap_];
+      const std::size_t seq = c.seq.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          ::new (static_cast<void*>(c.storage)) T(std::move(item));
+          c.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // full
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Pops the oldest item and hands it to consume() before destroying it.
+  // Safe against concurrent callers: producers evict through here too.
+  template <class Consume>
+  bool pop_with(Consume&& consume) {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& c = cells_[pos % cap_];
+      const std::size_t seq = c.seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) -
+                        static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          T* p = c.item();
+          consume(*p);
+          p->~T();
+          c.seq.store(pos + cap_, std::memory_order_release);
+          // One relaxed load unless a push_wait() caller is parked.
+          if (space_waiters_.load(std::memory_order_relaxed) != 0) {
+            notify_space();
+          }
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // empty
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool discard_one() {
+    return pop_with([](T&) {});
+  }
+
+  void published() {
+    update_peak();
+    bell_->ring();
+  }
+
+  void notify_space() {
+    { std::scoped_lock lk(space_m_); }
+    space_cv_.notify_all();
+  }
+
+  void update_peak() {
+    const std::size_t size = this->size();
+    std::size_t p = peak_.load(std::memory_order_relaxed);
+    while (size > p &&
+           !peak_.compare_exchange_weak(p, size, std::memory_order_relaxed)) {
+    }
+  }
+
+  const std::size_t cap_;
+  std::unique_ptr<Cell[]> cells_;
+
+  alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+  alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+  alignas(kCacheLineSize) std::atomic<std::size_t> peak_{0};
+  std::atomic<bool> stop_{false};
+  // Producers blocked in push_wait(); consumers notify them on pop.
+  alignas(kCacheLineSize) std::atomic<int> space_waiters_{0};
+  std::mutex space_m_;
+  std::condition_variable space_cv_;
+  Doorbell own_bell_;
+  Doorbell* bell_;
+};
+
+}  // namespace rover_logger
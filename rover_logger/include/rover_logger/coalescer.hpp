@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "rover_logger/log_message.hpp"
+
+namespace rover_logger {
+
+// Collapses repeats of a message (same module, level and text) within a
+// time window into one summary line.
+//
+// The first sighting passes straight through; repeats arriving within
+// `window` of it are only counted. When the window closes, a summary
+//   "<text> [repeated N times, first <ts>, last <ts>]"
+// stamped with the last repeat's time is emitted, if there were any.
+// Windows are measured on LogMessage::ts.
+//
+// At most max_entries distinct messages are tracked; a new one beyond that
+// closes the oldest window early. Not thread-safe: owned by the thread
+// that writes the sink.
+//
+// Messages are tracked by a 64-bit hash of module, level and text in a
+// fixed open-addressed table, so a first sighting costs a hash and a
+// probe and copies nothing; the text is copied on the first repeat and
+// checked against later ones. All storage is allocated up front.
+class Coalescer {
+ public:
+  using clock = LogMessage::clock;
+
+  Coalescer(std::chrono::milliseconds window, std::size_t max_entries);
+
+  // Appends msgs[0..count) to out minus the repeats, preceded by the
+  // summaries of windows that closed before each message.
+  void process(const LogMessage* msgs, std::size_t count,
+               std::vector<LogMessage>& out);
+  // Appends the summaries of windows closed by now.
+  void expire(clock::time_point now, std::vector<LogMessage>& out);
+  // Closes every window (shutdown).
+  void expire_all(std::vector<LogMessage>& out);
+  // When the next summary is due, if any repeats are pending.
+  std::optional<clock::time_point> next_due() const;
+
+  // Repeats absorbed so far. Safe to read from any thread.
+  std::uint64_t coalesced() const {
+    return coalesced_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // One tracked message; entries_ is a ring in window order, indexed by
+  // seq % max_entries.
+  struct Entry {
+    std::uint64_t hash = 0;
+    clock::time_point first_ts;
+    clock::time_point last_ts;
+    std::uint64_t repeats = 0;
+    ModuleId module = ModuleRegistry::kUnknown;
+    LogLevel level = LogLevel::INFO;
+    MessageText text;  // set on the first repeat
+  };
+  // Linear-probing table cell: hash -> seq of its entry.
+  struct Cell {
+    std::uint64_t hash = 0;
+    std::uint64_t seq = kEmpty;
+  };
+  static constexpr std::uint64_t kEmpty = ~std::uint64_t{0};
+
+  static std::uint64_t key(const LogMessage& msg);
+  Entry& entry(std::uint64_t seq) { return entries_[seq % max_entries_]; }
+  const Entry& entry(std::uint64_t seq) const {
+    return entries_[seq % max_entries_];
+  }
+  // The cell holding hash, or the empty cell where it would go.
+  std::size_t find(std::uint64_t hash) const;
+  void erase_cell(std::size_t i);
+  void close_oldest(std::vector<LogMessage>& out);
+
+  const clock::duration window_;
+  const std::size_t max_entries_;
+  std::vector<Entry> entries_;
+  std::uint64_t head_ = 0;  // seq of the oldest open window
+  std::size_t size_ = 0;    // open windows
+  std::vector<Cell> cells_;  // at most half full
+  std::size_t mask_ = 0;
+  // Min-heap of the seqs of entries with repeats. Windows close oldest
+  // first, so the top is both the next summary due and the next one
+  // closed.
+  std::vector<std::uint64_t> repeating_;
+  std::atomic<std::uint64_t> coalesced_{0};
+};
+
+}  // namespace rover_logger
@@ -25,6 +25,8 @@ namespace rover_logger {
 // Examples:
 //   - Terminal sink (prints to console)
 //   - File sink (writes to rotating log files)
+//   - Memory-mapped file sink ("mmap_file", preallocated segments)
+//   - io_uring file sink ("uring_file", asynchronous writes on Linux)
 //   - Network sink (TCP/UDP log streaming)
 // Each field is optional because different sink types require different fields.
 // ---------------------------------------------------------------------------
@@ -36,11 +38,130 @@ struct SinkConfig {
   std::optional<std::size_t> rotation_bytes; // File size before rotation
   std::optional<int> rotate_keep;          // Number of old rotated files to keep
   std::optional<bool> compress;            // Compress rotated logs if true
+  std::optional<int> compress_level;       // gzip level 1..9 (default 6)
+  std::optional<int> compress_nice;        // Niceness of compression thread
+  std::optional<std::string> timestamp;    // For file sinks: "iso8601_ms", ...
+  std::optional<std::string> format;       // For file sinks: "json", "text", "binary"
+  std::optional<LogLevel> flush_level;     // For file sinks: flush at/above
+  std::optional<LogLevel> sync_level;      // For file sinks: fsync at/above
+  std::optional<std::size_t> coalesce_window_ms; // Any sink: collapse repeats
+  std::optional<std::size_t> coalesce_entries;   // Distinct messages tracked
 
   std::optional<std::string> host;         // For network sinks: server address
   std::optional<int> port;                 // For network sinks: server port
 };
 
+// ---------------------------------------------------------------------------
+// CoalesceConfig
+// ---------------------------------------------------------------------------
+// Duplicate coalescing for one sink (see Coalescer): repeats of a message
+// (same module, level and text) within window_ms of its first sighting
+// reach the sink as one "[repeated N times, first ..., last ...]" line.
+// At most max_entries distinct messages are tracked at once.
+// From a sink's coalesce_window_ms / coalesce_entries keys.
+// ---------------------------------------------------------------------------
+struct CoalesceConfig {
+  std::size_t window_ms = 0;      // 0 = off
+  std::size_t max_entries = 64;   // Bounds memory (~300 bytes each)
+
+  bool enabled() const { return window_ms > 0; }
+};
+
+// ---------------------------------------------------------------------------
+// QueueMode
+// ---------------------------------------------------------------------------
+// How producers hand messages to the logger's worker thread:
+//   - Shared:    one lock-free queue that every thread pushes into.
+//   - PerThread: each producer thread gets its own queue on its first log()
+//                call; the worker merges them back into timestamp order.
+// ---------------------------------------------------------------------------
+enum class QueueMode { Shared, PerThread };
+
+// ---------------------------------------------------------------------------
+// OverflowPolicy
+// ---------------------------------------------------------------------------
+// What log() does when its queue is full:
+//   - DropOldest: evict the oldest queued message (never blocks).
+//   - DropNewest: discard the new message (never blocks).
+//   - Block:      wait up to block_timeout_ms for room, then drop the new
+//                 message.
+//   - LevelAware: shed by severity as the queue fills: TRACE/DEBUG are
+//                 refused once it is half full, INFO once it is 7/8 full.
+//                 WARN and above use the headroom left by that and, if
+//                 the queue is full anyway, wait like Block.
+// Drops are counted per level (Logger::dropped_by_level()).
+// ---------------------------------------------------------------------------
+enum class OverflowPolicy { DropOldest, DropNewest, Block, LevelAware };
+
+// ---------------------------------------------------------------------------
+// DispatchMode
+// ---------------------------------------------------------------------------
+// How the worker hands batches to the sinks:
+//   - Inline:  the worker writes every batch to each sink in turn (one
+//              thread; a slow sink delays the others).
+//   - PerSink: the worker fans each batch out into one queue per sink, and
+//              every sink writes from its own thread. A slow sink only
+//              backs up (and, when full, drops the oldest entries of) its
+//              own queue.
+// ---------------------------------------------------------------------------
+enum class DispatchMode { Inline, PerSink };
+
+// ---------------------------------------------------------------------------
+// ModuleLimit
+// ---------------------------------------------------------------------------
+// Traffic controls for one module (and its sub-modules, which share them),
+// applied before a message is queued:
+//   - rate / burst: token bucket. Up to `burst` messages at once, refilled
+//     at `rate` messages per second (rate 0 = unlimited; burst 0 = rate,
+//     at least 1).
+//   - sample: keep 1 in N messages per call site (1 = keep all). A call
+//     site is the format string of RVLOG_* messages; other messages are
+//     sampled per level.
+// What is held back is reported as "suppressed N similar messages" after
+// the module's next message that gets through (at most once a second).
+// Messages at or above emergency_level are never limited.
+// ---------------------------------------------------------------------------
+struct ModuleLimit {
+  double rate = 0;            // Messages per second (0 = unlimited)
+  std::size_t burst = 0;      // Bucket size (0 = rate)
+  std::size_t sample = 1;     // Keep 1 in N per call site
+
+  bool active() const { return rate > 0 || sample > 1; }
+};
+
+// ---------------------------------------------------------------------------
+// FlightRecorderConfig
+// ---------------------------------------------------------------------------
+// The in-memory crash recorder (see FlightRecorder): the last
+// records_per_thread messages of every thread at or above `level`, kept
+// even when the normal level filter discards them, and appended to `path`
+// on FATAL, on a crash signal (if on_signal) or on request.
+// ---------------------------------------------------------------------------
+struct FlightRecorderConfig {
+  bool enabled = false;
+  LogLevel level = LogLevel::TRACE;        // Record this level and above
+  std::size_t records_per_thread = 512;    // Ring size, 256 bytes each
+  std::string path = "rover_flight.log";   // Dumps are appended here
+  bool on_signal = true;                   // SIGSEGV/SIGABRT/... handlers
+  bool dump_on_exit = false;               // Also dump from ~Logger
+};
+
+// ---------------------------------------------------------------------------
+// TimestampFormat
+// ---------------------------------------------------------------------------
+// How structured sinks render LogMessage::ts:
+//   - Iso8601Millis/Micros/Nanos: "2025-01-01T12:00:00.123Z" (3/6/9 digits)
+//   - EpochMillis/Micros/Nanos:   integer time since the Unix epoch
+// ---------------------------------------------------------------------------
+enum class TimestampFormat {
+  Iso8601Millis,
+  Iso8601Micros,
+  Iso8601Nanos,
+  EpochMillis,
+  EpochMicros,
+  EpochNanos,
+};
+
 // ---------------------------------------------------------------------------
 // LoggerConfig
 // ---------------------------------------------------------------------------
@@ -49,19 +170,54 @@ struct SinkConfig {
 //
 // Fields:
 //   - level: Global minimum log level (e.g., INFO). Modules can override.
-//   - max_queue: Size of the internal async logging queue.
+//   - max_queue: Size of the internal async logging queue (per producer
+//     thread when queue_mode is PerThread).
+//   - queue_mode: Shared (default) or PerThread producer queues.
+//   - overflow: What to do when a queue is full (see OverflowPolicy).
+//   - block_timeout_ms: Longest wait for room under OverflowPolicy::Block
+//                       (and for WARN+ under LevelAware).
+//   - dispatch: Inline (default) or PerSink (see DispatchMode).
+//   - sink_queue: Size of each sink's queue under DispatchMode::PerSink
+//     (0 = same as max_queue).
+//   - batch_max: Max messages the worker hands to sinks in one batch.
+//   - batch_linger_ms: How long the worker may wait for a batch to fill
+//     once it has at least one message (0 = write immediately).
+//   - flush_interval_ms: Buffered sinks are flushed at least this often
+//     while they hold unflushed output (0 = only on shutdown / policy).
+//   - emergency_level: Messages at or above this level skip the queue:
+//     the logging thread drains what is queued, writes the message to
+//     every sink itself and syncs them before log() returns.
+//   - metrics_interval_ms: How often the ROS bridge publishes
+//     Logger::metrics_snapshot() (0 = never).
+//   - flight_recorder: Crash recorder settings (see FlightRecorderConfig).
 //   - sinks: List of all sinks (console, file, network).
 //   - modules: Per-module log level overrides.
 //     Example:
 //         modules["/nav"] = LogLevel::DEBUG;
+//     Overrides apply to sub-modules too: "/nav" also covers "/nav/planner"
+//     unless "/nav/planner" has its own entry (longest prefix wins).
+//   - module_limits: Per-module rate limits and sampling (see ModuleLimit),
+//     from the same `modules` section; same longest-prefix rule.
 //
 // This lets each subsystem control its logging verbosity independently.
 // ---------------------------------------------------------------------------
 struct LoggerConfig {
   LogLevel level = LogLevel::INFO;                 // Default global log level
   std::size_t max_queue = 4096;                    // Max async queue size
+  QueueMode queue_mode = QueueMode::Shared;        // Producer queue layout
+  OverflowPolicy overflow = OverflowPolicy::DropOldest; // Full-queue policy
+  std::size_t block_timeout_ms = 10;               // OverflowPolicy::Block
+  DispatchMode dispatch = DispatchMode::Inline;    // Worker -> sink fan-out
+  std::size_t sink_queue = 0;                      // PerSink queue size
+  std::size_t batch_max = 256;                     // Max messages per batch
+  std::size_t batch_linger_ms = 0;                 // Max wait to fill a batch
+  std::size_t flush_interval_ms = 1000;            // Periodic sink flush
+  LogLevel emergency_level = LogLevel::FATAL;      // Synchronous write + sync
+  std::size_t metrics_interval_ms = 0;             // Bridge metrics topic
+  FlightRecorderConfig flight_recorder;            // Crash flight recorder
   std::vector<SinkConfig> sinks;                   // List of output sinks
   std::unordered_map<std::string, LogLevel> modules; // Per-module log levels
+  std::unordered_map<std::string, ModuleLimit> module_limits; // Rate limits
 };
 
 // ---------------------------------------------------------------------------
@@ -74,6 +230,39 @@ struct LoggerConfig {
 // ---------------------------------------------------------------------------
 LogLevel parse_level(std::string_view s);
 
+// ---------------------------------------------------------------------------
+// parse_queue_mode
+// ---------------------------------------------------------------------------
+// Converts "shared" or "per_thread" into a QueueMode.
+// Throws std::invalid_argument for anything else.
+// ---------------------------------------------------------------------------
+QueueMode parse_queue_mode(std::string_view s);
+
+// ---------------------------------------------------------------------------
+// parse_overflow_policy
+// ---------------------------------------------------------------------------
+// Converts "drop_oldest" / "drop_newest" / "block" / "level_aware" into an
+// OverflowPolicy. Throws std::invalid_argument for anything else.
+// ---------------------------------------------------------------------------
+OverflowPolicy parse_overflow_policy(std::string_view s);
+
+// ---------------------------------------------------------------------------
+// parse_dispatch_mode
+// ---------------------------------------------------------------------------
+// Converts "inline" or "per_sink" into a DispatchMode.
+// Throws std::invalid_argument for anything else.
+// ---------------------------------------------------------------------------
+DispatchMode parse_dispatch_mode(std::string_view s);
+
+// ---------------------------------------------------------------------------
+// parse_timestamp_format
+// ---------------------------------------------------------------------------
+// Converts "iso8601_ms" / "iso8601_us" / "iso8601_ns" / "epoch_ms" /
+// "epoch_us" / "epoch_ns" into a TimestampFormat.
+// Throws std::invalid_argument for anything else.
+// ---------------------------------------------------------------------------
+TimestampFormat parse_timestamp_format(std::string_view s);
+
 // ---------------------------------------------------------------------------
 // load_config_file
 // ---------------------------------------------------------------------------
@@ -0,0 +1,198 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "rover_logger/log_message.hpp"
+
+namespace rover_logger {
+
+// Deferred printf formatting.
+//
+// The caller only copies the format-string pointer and a compact binary
+// encoding of the arguments into LogMessage::text; the worker thread runs
+// format_deferred() to produce the final text. Each argument is stored as a
+// one-byte tag followed by its value; strings are copied (length-prefixed,
+// NUL-terminated) so the caller's buffers may go away right after the call.
+namespace deferred_detail {
+
+enum class ArgTag : unsigned char {
+  Int,
+  UInt,
+  Double,
+  LongDouble,
+  Pointer,
+  String,
+};
+
+template <class T>
+inline constexpr bool is_c_string_v =
+    std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+template <class T>
+inline constexpr bool is_string_v = is_c_string_v<T> ||
+                                    std::is_same_v<T, std::string> ||
+                                    std::is_same_v<T, std::string_view>;
+
+template <class T>
+inline constexpr bool is_wide_string_v =
+    std::is_pointer_v<T> &&
+    (std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, wchar_t> ||
+     std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char16_t> ||
+     std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char32_t>);
+
+// Types whose value can be captured now and formatted later.
+template <class T>
+inline constexpr bool is_capturable_v =
+    (std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+     std::is_null_pointer_v<T> || std::is_pointer_v<T> || is_string_v<T>) &&
+    !is_wide_string_v<T>;
+
+// String literals arrive as char arrays; everything else passes through.
+template <class T>
+const T& decay_arg(const T& v) {
+  return v;
+}
+template <std::size_t N>
+const char* decay_arg(const char (&v)[N]) {
+  return v;
+}
+
+template <class T>
+std::string_view as_string_view(const T& v) {
+  if constexpr (is_c_string_v<T>) {
+    return v != nullptr ? std::string_view(v) : std::string_view("(null)");
+  } else {
+    return std::string_view(v);
+  }
+}
+
+template <class T>
+std::size_t encoded_size(const T& v) {
+  if constexpr (is_string_v<T>) {
+    return 1 + sizeof(std::uint32_t) + as_string_view(v).size() + 1;
+  } else if constexpr (std::is_same_v<T, long double>) {
+    return 1 + sizeof(long double);
+  } else {
+    return 1 + sizeof(std::uint64_t);
+  }
+}
+
+template <class V>
+unsigned char* put(unsigned char* p, ArgTag tag, const V& v) {
+  *p++ = static_cast<unsigned char>(tag);
+  std::memcpy(p, &v, sizeof(V));
+  return p + sizeof(V);
+}
+
+template <class T>
+unsigned char* encode(unsigned char* p, const T& v) {
+  if constexpr (is_string_v<T>) {
+    const std::string_view s = as_string_view(v);
+    const auto len = static_cast<std::uint32_t>(s.size());
+    p = put(p, ArgTag::String, len);
+    if (len != 0) std::memcpy(p, s.data(), len);
+    p[len] = '\0';
+    return p + len + 1;
+  } else if constexpr (std::is_same_v<T, long double>) {
+    return put(p, ArgTag::LongDouble, v);
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return put(p, ArgTag::Double, static_cast<double>(v));
+  } else if constexpr (std::is_enum_v<T>) {
+    using U = std::underlying_type_t<T>;
+    return encode(p, static_cast<U>(v));
+  } else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+    return put(p, ArgTag::Pointer,
+               static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(
+                   static_cast<const void*>(v))));
+  } else if constexpr (std::is_signed_v<T>) {
+    return put(p, ArgTag::Int, static_cast<std::int64_t>(v));
+  } else {
+    return put(p, ArgTag::UInt, static_cast<std::uint64_t>(v));
+  }
+}
+
+// One decoded argument (see ArgReader).
+struct Arg {
+  ArgTag tag = ArgTag::Int;
+  std::int64_t i = 0;
+  std::uint64_t u = 0;
+  double d = 0.0;
+  long double ld = 0.0L;
+  const char* s = nullptr;  // NUL-terminated copy inside the message
+};
+
+// Walks the tagged argument encoding produced by capture_deferred().
+// Bounds-checked and allocation-free, so truncated input just ends early
+// and the flight recorder can use it from a signal handler.
+class ArgReader {
+ public:
+  ArgReader(const char* data, std::size_t size)
+      : p_(reinterpret_cast<const unsigned char*>(data)), end_(p_ + size) {}
+
+  bool next(Arg& a) {
+    if (p_ >= end_) return false;
+    a.tag = static_cast<ArgTag>(*p_++);
+    switch (a.tag) {
+      case ArgTag::Int:
+        return get(a.i);
+      case ArgTag::UInt:
+      case ArgTag::Pointer:
+        return get(a.u);
+      case ArgTag::Double:
+        return get(a.d);
+      case ArgTag::LongDouble:
+        return get(a.ld);
+      case ArgTag::String: {
+        std::uint32_t len = 0;
+        if (!get(len) || static_cast<std::size_t>(end_ - p_) < len + 1u) {
+          return false;
+        }
+        a.s = reinterpret_cast<const char*>(p_);
+        p_ += len + 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  template <class V>
+  bool get(V& v) {
+    if (static_cast<std::size_t>(end_ - p_) < sizeof(V)) return false;
+    std::memcpy(&v, p_, sizeof(V));
+    p_ += sizeof(V);
+    return true;
+  }
+
+  const unsigned char* p_;
+  const unsigned char* end_;
+};
+
+}  // namespace deferred_detail
+
+// Captures fmt and args into msg (see above). fmt must outlive the message;
+// the RVLOG_* macros only accept string literals for this reason.
+template <class... Args>
+void capture_deferred(LogMessage& msg, const char* fmt, const Args&... args) {
+  static_assert(
+      (deferred_detail::is_capturable_v<Args> && ...),
+      "RVLOG_* arguments must be arithmetic, enum, pointer or string "
+      "(const char*, std::string, std::string_view) values");
+
+  const std::size_t n =
+      (std::size_t{0} + ... + deferred_detail::encoded_size(args));
+  auto* p = reinterpret_cast<unsigned char*>(msg.text.resize_for_write(n));
+  ((p = deferred_detail::encode(p, args)), ...);
+  (void)p;
+  msg.fmt = fmt;
+}
+
+// Worker side: renders msg.fmt with the captured arguments into msg.text
+// and clears msg.fmt. scratch is reused between calls to avoid allocating.
+void format_deferred(LogMessage& msg, std::string& scratch);
+
+}  // namespace rover_logger
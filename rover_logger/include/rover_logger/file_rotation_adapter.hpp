@@ -4,7 +4,9 @@
 #include <string>
 #include <utility>
 
+#include "rover_logger/binary_format.hpp"
 #include "rover_logger/json_formatter.hpp"
+#include "rover_logger/log_compactor.hpp"
 #include "rover_logger/log_message.hpp"
 #include "rover_logger/logger.hpp"
 
@@ -13,13 +15,25 @@
 
 namespace rover_logger {
 
-// Choose between human-readable or JSON in the rotating files.
-enum class AdaptFormat { Text, JSON };
+// Choose between human-readable, JSON or compact binary (see
+// binary_format.hpp) in the rotating files.
+enum class AdaptFormat { Text, JSON, Binary };
 
 struct FileRotationAdapterOptions {
   std::string base_filename;  // e.g. "rover_log"
   std::size_t rotation_bytes; // e.g. 500 MB
   AdaptFormat format = AdaptFormat::JSON;
+  TimestampFormat timestamp = TimestampFormat::Iso8601Millis;  // JSON only
+  // Flush policy. Lower levels stay buffered until the buffer fills, a
+  // rotation, or the Logger's periodic flush().
+  LogLevel flush_level = LogLevel::WARN;  // write through to the OS
+  LogLevel sync_level = LogLevel::ERROR;  // ... and fsync
+  // Rotated files: gzip them and/or keep only the newest rotate_keep
+  // (< 0 = keep all). Done on a background LogCompactor thread.
+  bool compress = false;
+  int rotate_keep = -1;
+  int compress_level = 6;
+  int compress_nice = 10;
 };
 
 // Wrap teammate's FileRotationSink so it can accept LogMessage.
@@ -27,33 +41,120 @@ class FileRotationAdapter final : public ILogSink {
  public:
   explicit FileRotationAdapter(FileRotationAdapterOptions opt)
       : opt_(std::move(opt)),
+        ts_(opt_.timestamp),
         sink_(std::make_unique<FileRotationSink>(
-            opt_.base_filename, opt_.rotation_bytes)) {}
+            opt_.base_filename, opt_.rotation_bytes)) {
+    if (opt_.compress || opt_.rotate_keep >= 0) {
+      LogCompactorOptions copt;
+      copt.base_filename = opt_.base_filename;
+      copt.compress = opt_.compress;
+      copt.level = opt_.compress_level;
+      copt.keep = opt_.rotate_keep;
+      copt.nice = opt_.compress_nice;
+      compactor_ = std::make_unique<LogCompactor>(std::move(copt));
+    }
+    if (compactor_ || opt_.format == AdaptFormat::Binary) {
+      // Runs under m_ (inside a write), so need_header_ needs no locking.
+      sink_->setRotateCallback([this](int index) {
+        need_header_ = true;
+        if (compactor_) compactor_->notify_rotated(index);
+      });
+    }
+  }
 
   void write(const LogMessage& msg) override {
     std::scoped_lock lk(m_);
-    if (opt_.format == AdaptFormat::JSON) {
-      sink_->write(to_json_line(msg));
+    batch_buf_.clear();
+    if (opt_.format == AdaptFormat::Binary) {
+      write_binary(msg);
     } else {
-      std::string line;
-      line.reserve(32 + msg.module.size() + msg.text.size());
-      line.append("[")
-          .append(std::string(to_string(msg.level)))
-          .append("] (")
-          .append(msg.module)
-          .append(") ")
-          .append(msg.text);
-      sink_->write(line);
+      if (opt_.format == AdaptFormat::JSON) {
+        append_json_line(batch_buf_, msg, ts_);
+      } else {
+        append_text_line(batch_buf_, msg);
+      }
+      sink_->write(batch_buf_);
     }
+    apply_flush_policy(msg.level);
+  }
+
+  // Formats the whole batch into one buffer and hands it over in one go.
+  void write_batch(const LogMessage* msgs, std::size_t count) override {
+    std::scoped_lock lk(m_);
+    batch_buf_.clear();
+    LogLevel highest = LogLevel::TRACE;
+    if (opt_.format == AdaptFormat::Binary) {
+      // Record by record, so a rotation can start the next file with its
+      // own header and module dictionary.
+      for (std::size_t i = 0; i < count; ++i) {
+        if (msgs[i].level > highest) highest = msgs[i].level;
+        batch_buf_.clear();
+        write_binary(msgs[i]);
+      }
+      apply_flush_policy(highest);
+      return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      if (msgs[i].level > highest) highest = msgs[i].level;
+      if (opt_.format == AdaptFormat::JSON) {
+        append_json_line(batch_buf_, msgs[i], ts_);
+      } else {
+        append_text_line(batch_buf_, msgs[i]);
+      }
+      batch_buf_.push_back('\n');
+    }
+    sink_->writeBlock(batch_buf_);
+    apply_flush_policy(highest);
   }
 
   void flush() override {
-    // teammate sink flushes on std::endl
+    std::scoped_lock lk(m_);
+    sink_->flush();
   }
 
+  void sync() override {
+    std::scoped_lock lk(m_);
+    sink_->sync();
+  }
+
+  const char* name() const override { return "file"; }
+
  private:
+  void apply_flush_policy(LogLevel highest) {
+    if (highest >= opt_.sync_level) {
+      sink_->sync();
+    } else if (highest >= opt_.flush_level) {
+      sink_->flush();
+    }
+  }
+
+  void write_binary(const LogMessage& msg) {
+    if (need_header_) {
+      encoder_.begin_file(batch_buf_);
+      need_header_ = false;
+    }
+    encoder_.append(batch_buf_, msg);
+    sink_->writeRecord(batch_buf_.data(), batch_buf_.size());
+  }
+
+  static void append_text_line(std::string& out, const LogMessage& msg) {
+    out.reserve(out.size() + 32 + msg.module.size() + msg.text.size());
+    out.append("[")
+        .append(to_string(msg.level))
+        .append("] (")
+        .append(msg.module.view())
+        .append(") ")
+        .append(msg.text.view());
+  }
+
   FileRotationAdapterOptions opt_;
+  TimestampFormatter ts_;  // per-sink second cache
+  // Declared before sink_ so it outlives the sink's final rotation/flush.
+  std::unique_ptr<LogCompactor> compactor_;
   std::unique_ptr<FileRotationSink> sink_;
+  std::string batch_buf_;  // reused across batches
+  BinaryLogEncoder encoder_;
+  bool need_header_ = true;  // binary: next record starts a new file
   std::mutex m_;
 };
 
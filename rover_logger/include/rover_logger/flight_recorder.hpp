@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rover_logger/log_message.hpp"
+
+namespace rover_logger {
+
+// In-memory crash recorder: the last N messages of every thread, kept
+// whether or not they passed the level filter, and written to a file when
+// something goes wrong.
+//
+// Each thread records into its own ring of fixed 256-byte slots: one copy,
+// no locks, no allocation after the thread's first record. Text longer
+// than a slot is truncated. Deferred messages are kept unformatted (format
+// pointer + captured arguments) and only rendered when dumped.
+//
+// dump() uses async-signal-safe calls only (open/write/fsync; no malloc,
+// locks or stdio), so it can run from a crash handler while other threads
+// keep logging. A slot overwritten mid-dump is skipped, not torn.
+class FlightRecorder {
+ public:
+  // Rings are reused once their thread exits; past this many concurrently
+  // logging threads, the extra threads are not recorded.
+  static constexpr std::size_t kMaxThreads = 64;
+  static constexpr std::size_t kSlotBytes = 256;
+
+  FlightRecorder(std::string path, std::size_t records_per_thread);
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder&) = delete;
+  FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+  void record(const LogMessage& msg);
+
+  // Appends a header line naming reason, then every ring merged into
+  // timestamp order, to path() and fsyncs it. False if it can't be written.
+  // Concurrent calls are serialized.
+  bool dump(const char* reason) const;
+
+  // Dumps every live FlightRecorder on SIGSEGV, SIGBUS, SIGFPE, SIGILL and
+  // SIGABRT, then passes the signal on to the handler installed before
+  // (by default: terminate with a core dump). Idempotent.
+  //
+  // The calling thread, and from then on every thread when it first
+  // records, gets its own alternate signal stack, so a stack overflow
+  // there still dumps. A thread that never logs has none: an overflow on
+  // it is not caught.
+  static void install_crash_handlers();
+
+  const std::string& path() const { return path_; }
+  std::size_t records_per_thread() const { return cap_; }
+  // Messages not recorded because kMaxThreads threads already had rings.
+  std::uint64_t unrecorded() const {
+    return unrecorded_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Slot;
+  struct Ring;
+
+  Ring* ring();  // the calling thread's, or nullptr when none is free
+  std::shared_ptr<Ring> claim_ring();
+  // Copies record k of r, or returns false if it is gone or half-written.
+  bool read_record(const Ring& r, std::uint64_t k, Slot& out) const;
+  bool read_ts(const Ring& r, std::uint64_t k, std::int64_t& ts_ns) const;
+  bool write_dump(const char* reason) const;  // async-signal-safe
+  static void on_crash_signal(int sig);
+
+  const std::string path_;
+  const std::size_t cap_;
+  const std::uint64_t id_;  // tells recorders apart in thread caches
+
+  // Read lock-free by dump(); rings are only ever added.
+  std::atomic<Ring*> rings_[kMaxThreads];
+  std::atomic<std::size_t> ring_count_{0};
+  std::mutex rings_mutex_;  // claim_ring() only
+  std::vector<std::shared_ptr<Ring>> owned_;
+  std::atomic<std::uint64_t> unrecorded_{0};
+  mutable std::mutex dump_mutex_;  // dump(); the signal handler skips it
+};
+
+}  // namespace rover_logger
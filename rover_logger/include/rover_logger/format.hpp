@@ -0,0 +1,509 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ratio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "rover_logger/log_message.hpp"
+
+namespace rover_logger {
+
+// Type-safe {}-style formatting (the common subset of fmt / std::format).
+//
+//   "x={} y={:.2f}"  "{:>8}"  "{:#x}"  "{:*^12}"  "{{literal}}"
+//
+// A field is {} or {:spec}, spec = [[fill]align][sign][#][0][width]
+// [.precision][type], and fields take the arguments in order (no explicit
+// indices). The format string is parsed at compile time: format_to()
+// static_asserts that fields, specs and argument types agree, and at run
+// time only walks the pre-parsed segments, writing straight into a
+// MessageText.
+//
+// Supported: integers, floating point (shortest round-trip by default),
+// bool, char, strings, pointers, enums (as their underlying value),
+// std::chrono durations ("250ms", the spec applies to the count) and
+// Eigen-style vectors ("[1, 2, 3]", the spec applies to each element).
+// Specialise Formatter for other types.
+
+// How a field's spec is validated and interpreted.
+enum class ArgKind : unsigned char {
+  None,
+  Int,
+  Float,
+  Char,
+  Bool,
+  String,
+  Pointer,
+};
+
+struct FormatSpec {
+  char fill = ' ';
+  char align = 0;  // '<', '>', '^' or 0 for the type's default
+  char sign = 0;   // '+', ' ', '-' or 0
+  bool alt = false;   // '#'
+  bool zero = false;  // '0'
+  char type = 0;
+  std::int16_t width = 0;
+  std::int16_t precision = -1;
+};
+
+// Appends to a MessageText, growing it (into the overflow pool) as needed.
+// The text is cut to what was written when the writer goes away.
+class TextWriter {
+ public:
+  explicit TextWriter(MessageText& out)
+      : out_(out),
+        buf_(out.resize_for_write(MessageText::kInlineCapacity - 1)),
+        cap_(MessageText::kInlineCapacity - 1) {}
+  ~TextWriter() { out_.truncate(len_); }
+  TextWriter(const TextWriter&) = delete;
+  TextWriter& operator=(const TextWriter&) = delete;
+
+  void append(std::string_view s) {
+    if (s.empty()) return;
+    std::memcpy(reserve(s.size()), s.data(), s.size());
+    len_ += s.size();
+  }
+  void append(char c, std::size_t count = 1) {
+    std::memset(reserve(count), c, count);
+    len_ += count;
+  }
+  // Writes s padded to spec.width; align applies when the spec has none.
+  void append_padded(std::string_view s, const FormatSpec& spec, char align);
+
+  std::size_t size() const { return len_; }
+
+ private:
+  char* reserve(std::size_t n) {
+    if (cap_ - len_ < n) grow(n);
+    return buf_ + len_;
+  }
+  void grow(std::size_t n);
+
+  MessageText& out_;
+  char* buf_;
+  std::size_t cap_;
+  std::size_t len_ = 0;
+};
+
+// Numbers, rendered without locale or format-string parsing.
+void write_int(TextWriter& out, std::uint64_t magnitude, bool negative,
+               const FormatSpec& spec);
+void write_float(TextWriter& out, double v, const FormatSpec& spec);
+void write_float(TextWriter& out, float v, const FormatSpec& spec);
+
+// Formatter<T>: kind selects the spec rules checked at compile time;
+// format() writes one value. The primary template marks T unsupported.
+template <class T, class Enable = void>
+struct Formatter {
+  static constexpr ArgKind kind = ArgKind::None;
+};
+
+namespace format_detail {
+
+template <class T>
+inline constexpr bool is_char_v =
+    std::is_same_v<T, char> || std::is_same_v<T, wchar_t> ||
+    std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>;
+
+// Eigen vectors and vector expressions (no Eigen dependency needed).
+template <class T, class = void>
+struct is_vector_like : std::false_type {};
+template <class T>
+struct is_vector_like<
+    T, std::void_t<typename T::Scalar, decltype(T::IsVectorAtCompileTime),
+                   decltype(std::declval<const T&>().size()),
+                   decltype(std::declval<const T&>().coeff(0))>>
+    : std::bool_constant<bool(T::IsVectorAtCompileTime) &&
+                         std::is_arithmetic_v<typename T::Scalar>> {};
+
+template <class Period>
+constexpr std::string_view unit_suffix() {
+  if constexpr (std::is_same_v<Period, std::nano>) return "ns";
+  else if constexpr (std::is_same_v<Period, std::micro>) return "us";
+  else if constexpr (std::is_same_v<Period, std::milli>) return "ms";
+  else if constexpr (std::is_same_v<Period, std::ratio<1>>) return "s";
+  else if constexpr (std::is_same_v<Period, std::ratio<60>>) return "min";
+  else if constexpr (std::is_same_v<Period, std::ratio<3600>>) return "h";
+  else return {};
+}
+
+}  // namespace format_detail
+
+template <class T>
+struct Formatter<T, std::enable_if_t<std::is_integral_v<T> &&
+                                     !std::is_same_v<T, bool> &&
+                                     !format_detail::is_char_v<T>>> {
+  static constexpr ArgKind kind = ArgKind::Int;
+  static void format(TextWriter& out, T v, const FormatSpec& spec) {
+    if constexpr (std::is_signed_v<T>) {
+      const auto u = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+      write_int(out, v < 0 ? ~u + 1 : u, v < 0, spec);
+    } else {
+      write_int(out, static_cast<std::uint64_t>(v), false, spec);
+    }
+  }
+};
+
+template <class T>
+struct Formatter<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+  static constexpr ArgKind kind = ArgKind::Float;
+  static void format(TextWriter& out, T v, const FormatSpec& spec) {
+    if constexpr (std::is_same_v<T, float>) {
+      write_float(out, v, spec);
+    } else {
+      write_float(out, static_cast<double>(v), spec);  // long double too
+    }
+  }
+};
+
+template <class T>
+struct Formatter<T, std::enable_if_t<std::is_enum_v<T>>> {
+  using Underlying = Formatter<std::underlying_type_t<T>>;
+  static constexpr ArgKind kind = Underlying::kind;
+  static void format(TextWriter& out, T v, const FormatSpec& spec) {
+    Underlying::format(out, static_cast<std::underlying_type_t<T>>(v), spec);
+  }
+};
+
+template <>
+struct Formatter<bool> {
+  static constexpr ArgKind kind = ArgKind::Bool;
+  static void format(TextWriter& out, bool v, const FormatSpec& spec) {
+    out.append_padded(v ? "true" : "false", spec, '<');
+  }
+};
+
+template <>
+struct Formatter<char> {
+  static constexpr ArgKind kind = ArgKind::Char;
+  static void format(TextWriter& out, char v, const FormatSpec& spec) {
+    out.append_padded(std::string_view(&v, 1), spec, '<');
+  }
+};
+
+template <>
+struct Formatter<std::string_view> {
+  static constexpr ArgKind kind = ArgKind::String;
+  static void format(TextWriter& out, std::string_view v,
+                     const FormatSpec& spec) {
+    if (spec.precision >= 0) {
+      v = v.substr(0, static_cast<std::size_t>(spec.precision));
+    }
+    out.append_padded(v, spec, '<');
+  }
+};
+template <>
+struct Formatter<std::string> : Formatter<std::string_view> {};
+template <>
+struct Formatter<const char*> : Formatter<std::string_view> {
+  static void format(TextWriter& out, const char* v, const FormatSpec& spec) {
+    Formatter<std::string_view>::format(
+        out, v != nullptr ? std::string_view(v) : std::string_view("(null)"),
+        spec);
+  }
+};
+template <>
+struct Formatter<char*> : Formatter<const char*> {};
+template <std::size_t N>
+struct Formatter<char[N]> : Formatter<const char*> {};
+
+template <class T>
+struct Formatter<
+    T*, std::enable_if_t<(std::is_object_v<T> || std::is_void_v<T>) &&
+                         !format_detail::is_char_v<std::remove_cv_t<T>>>> {
+  static constexpr ArgKind kind = ArgKind::Pointer;
+  static void format(TextWriter& out, const T* v, const FormatSpec& spec) {
+    FormatSpec hex = spec;
+    hex.type = 'x';
+    hex.alt = true;
+    write_int(out, reinterpret_cast<std::uintptr_t>(v), false, hex);
+  }
+};
+template <>
+struct Formatter<std::nullptr_t> : Formatter<const void*> {};
+
+template <class Rep, class Period>
+struct Formatter<std::chrono::duration<Rep, Period>> {
+  static constexpr ArgKind kind = Formatter<Rep>::kind;
+  static void format(TextWriter& out,
+                     const std::chrono::duration<Rep, Period>& d,
+                     const FormatSpec& spec) {
+    Formatter<Rep>::format(out, d.count(), spec);
+    constexpr std::string_view suffix = format_detail::unit_suffix<Period>();
+    if constexpr (!suffix.empty()) {
+      out.append(suffix);
+    } else {
+      out.append('[');
+      write_int(out, static_cast<std::uint64_t>(Period::num), false, {});
+      out.append('/');
+      write_int(out, static_cast<std::uint64_t>(Period::den), false, {});
+      out.append("]s");
+    }
+  }
+};
+
+template <class T>
+struct Formatter<T, std::enable_if_t<format_detail::is_vector_like<T>::value>> {
+  using Element = Formatter<typename T::Scalar>;
+  static constexpr ArgKind kind = Element::kind;
+  static void format(TextWriter& out, const T& v, const FormatSpec& spec) {
+    out.append('[');
+    for (decltype(v.size()) i = 0; i < v.size(); ++i) {
+      if (i != 0) out.append(", ");
+      Element::format(out, v.coeff(i), spec);
+    }
+    out.append(']');
+  }
+};
+
+namespace format_detail {
+
+enum class FormatError : unsigned char {
+  None,
+  UnmatchedBrace,
+  BadSpec,
+  PositionalField,
+  TooFewArgs,
+  TooManyArgs,
+  UnsupportedType,
+  SpecTypeMismatch,
+};
+
+inline constexpr int kMaxWidth = 255;
+inline constexpr int kMaxPrecision = 100;
+
+constexpr bool is_align(char c) { return c == '<' || c == '>' || c == '^'; }
+constexpr bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+constexpr FormatError parse_spec(std::string_view s, FormatSpec& spec) {
+  std::size_t i = 0;
+  if (s.size() >= 2 && is_align(s[1])) {
+    if (s[0] == '{') return FormatError::BadSpec;
+    spec.fill = s[0];
+    spec.align = s[1];
+    i = 2;
+  } else if (!s.empty() && is_align(s[0])) {
+    spec.align = s[0];
+    i = 1;
+  }
+  if (i < s.size() && (s[i] == '+' || s[i] == '-' || s[i] == ' ')) {
+    spec.sign = s[i++];
+  }
+  if (i < s.size() && s[i] == '#') {
+    spec.alt = true;
+    ++i;
+  }
+  if (i < s.size() && s[i] == '0') {
+    spec.zero = true;
+    ++i;
+  }
+
+  int width = 0;
+  for (; i < s.size() && is_digit(s[i]); ++i) {
+    width = width * 10 + (s[i] - '0');
+    if (width > kMaxWidth) return FormatError::BadSpec;
+  }
+  spec.width = static_cast<std::int16_t>(width);
+
+  if (i < s.size() && s[i] == '.') {
+    if (++i >= s.size() || !is_digit(s[i])) return FormatError::BadSpec;
+    int precision = 0;
+    for (; i < s.size() && is_digit(s[i]); ++i) {
+      precision = precision * 10 + (s[i] - '0');
+      if (precision > kMaxPrecision) return FormatError::BadSpec;
+    }
+    spec.precision = static_cast<std::int16_t>(precision);
+  }
+  if (i < s.size()) spec.type = s[i++];
+  return i == s.size() ? FormatError::None : FormatError::BadSpec;
+}
+
+constexpr bool one_of(char c, std::string_view set) {
+  return set.find(c) != std::string_view::npos;
+}
+
+// Whether spec makes sense for an argument of the given kind.
+constexpr bool spec_fits(ArgKind kind, const FormatSpec& s) {
+  const bool plain = s.sign == 0 && !s.alt && !s.zero;
+  switch (kind) {
+    case ArgKind::Int:
+      return s.precision < 0 && (s.type == 0 || one_of(s.type, "dxXob"));
+    case ArgKind::Float:
+      return !s.alt && (s.type == 0 || one_of(s.type, "fFeEgG"));
+    case ArgKind::Char:
+      return plain && s.precision < 0 && (s.type == 0 || s.type == 'c');
+    case ArgKind::Bool:
+    case ArgKind::String:
+      return plain && (s.type == 0 || s.type == 's') &&
+             (kind == ArgKind::String || s.precision < 0);
+    case ArgKind::Pointer:
+      return plain && s.precision < 0 && (s.type == 0 || s.type == 'p');
+    case ArgKind::None:
+      break;
+  }
+  return false;
+}
+
+// Splits fmt into literal text (escapes resolved) and fields, calling
+// on_text(begin, size) and on_field(spec) in order.
+template <class OnText, class OnField>
+constexpr FormatError parse_format(std::string_view fmt, OnText&& on_text,
+                                   OnField&& on_field) {
+  std::size_t lit = 0;  // start of the pending literal
+  auto flush = [&](std::size_t end) {
+    if (end > lit) on_text(lit, end - lit);
+  };
+  for (std::size_t i = 0; i < fmt.size(); ++i) {
+    if (fmt[i] == '}') {
+      if (i + 1 >= fmt.size() || fmt[i + 1] != '}') {
+        return FormatError::UnmatchedBrace;
+      }
+      flush(i + 1);  // keep one '}'
+      lit = ++i + 1;
+      continue;
+    }
+    if (fmt[i] != '{') continue;
+    if (i + 1 < fmt.size() && fmt[i + 1] == '{') {
+      flush(i + 1);
+      lit = ++i + 1;
+      continue;
+    }
+    const std::size_t close = fmt.find('}', i);
+    if (close == std::string_view::npos) return FormatError::UnmatchedBrace;
+    const std::string_view body = fmt.substr(i + 1, close - i - 1);
+    FormatSpec spec{};
+    if (!body.empty()) {
+      if (body[0] != ':') {
+        return is_digit(body[0]) ? FormatError::PositionalField
+                                 : FormatError::BadSpec;
+      }
+      const FormatError e = parse_spec(body.substr(1), spec);
+      if (e != FormatError::None) return e;
+    }
+    flush(i);
+    on_field(spec);
+    lit = close + 1;
+    i = close;
+  }
+  flush(fmt.size());
+  return FormatError::None;
+}
+
+template <class... Args>
+constexpr FormatError check_format(std::string_view fmt) {
+  constexpr ArgKind kinds[] = {Formatter<Args>::kind..., ArgKind::None};
+  constexpr std::size_t nargs = sizeof...(Args);
+  for (std::size_t k = 0; k < nargs; ++k) {
+    if (kinds[k] == ArgKind::None) return FormatError::UnsupportedType;
+  }
+  std::size_t field = 0;
+  bool fits = true;
+  const FormatError e = parse_format(
+      fmt, [](std::size_t, std::size_t) {},
+      [&](const FormatSpec& spec) {
+        if (field < nargs && !spec_fits(kinds[field], spec)) fits = false;
+        ++field;
+      });
+  if (e != FormatError::None) return e;
+  if (field > nargs) return FormatError::TooFewArgs;
+  if (field < nargs) return FormatError::TooManyArgs;
+  return fits ? FormatError::None : FormatError::SpecTypeMismatch;
+}
+
+// One piece of a parsed format string: literal text or a field.
+struct Segment {
+  std::uint32_t begin = 0;  // literal: Fmt::str().substr(begin, size)
+  std::uint32_t size = 0;
+  bool field = false;
+  FormatSpec spec{};
+};
+
+template <class Fmt>
+constexpr std::size_t segment_count() {
+  std::size_t n = 0;
+  parse_format(
+      Fmt::str(), [&](std::size_t, std::size_t) { ++n; },
+      [&](const FormatSpec&) { ++n; });
+  return n;
+}
+
+template <class Fmt>
+constexpr std::array<Segment, segment_count<Fmt>()> parse_segments() {
+  std::array<Segment, segment_count<Fmt>()> segs{};
+  std::size_t n = 0;
+  parse_format(
+      Fmt::str(),
+      [&](std::size_t begin, std::size_t size) {
+        segs[n].begin = static_cast<std::uint32_t>(begin);
+        segs[n].size = static_cast<std::uint32_t>(size);
+        ++n;
+      },
+      [&](const FormatSpec& spec) {
+        segs[n].field = true;
+        segs[n].spec = spec;
+        ++n;
+      });
+  return segs;
+}
+
+template <class Fmt>
+inline constexpr auto kSegments = parse_segments<Fmt>();
+
+template <class T>
+using formatted_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+}  // namespace format_detail
+
+// Formats args into out according to Fmt, a type whose static constexpr
+// str() returns the format string (the RVLOG_*F macros declare one per
+// statement). Mismatches between the string and the arguments are
+// compile errors.
+template <class Fmt, class... Args>
+void format_to(MessageText& out, const Args&... args) {
+  using format_detail::FormatError;
+  constexpr FormatError kError =
+      format_detail::check_format<Args...>(Fmt::str());
+  static_assert(kError != FormatError::UnmatchedBrace,
+                "format string: unmatched '{' or '}' (write {{ or }} for a "
+                "literal brace)");
+  static_assert(kError != FormatError::BadSpec,
+                "format string: malformed {:spec}");
+  static_assert(kError != FormatError::PositionalField,
+                "format string: argument indices are not supported, use {}");
+  static_assert(kError != FormatError::TooFewArgs,
+                "format string has more {} fields than arguments");
+  static_assert(kError != FormatError::TooManyArgs,
+                "more arguments than {} fields in the format string");
+  static_assert(kError != FormatError::UnsupportedType,
+                "argument type has no rover_logger::Formatter");
+  static_assert(kError != FormatError::SpecTypeMismatch,
+                "format spec does not fit the argument type (e.g. {:x} on a "
+                "string, {:.2} on an integer)");
+
+  if constexpr (kError == FormatError::None) {
+    constexpr auto& segs = format_detail::kSegments<Fmt>;
+    constexpr std::string_view text = Fmt::str();
+    TextWriter w(out);
+    std::size_t i = 0;
+    const auto field = [&](const auto& arg) {
+      for (; !segs[i].field; ++i) {
+        w.append(text.substr(segs[i].begin, segs[i].size));
+      }
+      using F = Formatter<format_detail::formatted_t<decltype(arg)>>;
+      F::format(w, arg, segs[i++].spec);
+    };
+    (field(args), ...);
+    for (; i < segs.size(); ++i) {
+      w.append(text.substr(segs[i].begin, segs[i].size));
+    }
+  }
+}
+
+}  // namespace rover_logger
@@ -1,13 +1,46 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <string_view>
 
+#include "rover_logger/config.hpp"
 #include "rover_logger/log_level.hpp"
 #include "rover_logger/log_message.hpp"
 
 namespace rover_logger {
 
+// Renders timestamps for structured output. ISO 8601 output keeps the
+// "YYYY-MM-DDTHH:MM:SS" prefix of the last second it saw and only writes
+// the fractional digits for later timestamps in the same second, so one
+// instance should be owned per sink (or per thread) and not shared.
+class TimestampFormatter {
+ public:
+  explicit TimestampFormatter(
+      TimestampFormat fmt = TimestampFormat::Iso8601Millis)
+      : fmt_(fmt) {}
+
+  TimestampFormat format() const { return fmt_; }
+  // Epoch formats are bare integers; ISO 8601 ones need quoting in JSON.
+  bool is_integer() const;
+
+  void append(std::string& out, const LogMessage::clock::time_point& tp);
+
+ private:
+  TimestampFormat fmt_;
+  std::int64_t cached_sec_ = INT64_MIN;
+  char prefix_[20] = {};  // "YYYY-MM-DDTHH:MM:SS"
+};
+
+// One JSON object (no trailing newline) appended to out.
+void append_json_line(std::string& out, const LogMessage& msg,
+                      TimestampFormatter& ts);
+
 std::string to_json_line(const LogMessage& msg);
+
+// Appends s to out with JSON string escaping (no surrounding quotes).
+// Clean runs are found 16/32 bytes at a time (SSE2/AVX2, picked at
+// startup) and copied in bulk.
+void append_json_escaped(std::string& out, std::string_view s);
 std::string json_escape(std::string_view s);
 std::string iso8601_utc_ms(const LogMessage::clock::time_point& tp);
 
@@ -0,0 +1,58 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace rover_logger {
+
+struct LogCompactorOptions {
+  std::string base_filename;  // same base as the FileRotationSink
+  bool compress = true;       // gzip rotated files to <file>.gz
+  int level = 6;              // zlib level, 1 (fast) .. 9 (small)
+  int keep = -1;              // rotated files to keep; < 0 keeps all
+  int nice = 10;              // niceness of the compaction thread (Linux)
+};
+
+// Background compaction of rotated log files.
+//
+// FileRotationSink reports each file it closes through notify_rotated(),
+// which only queues the job; compression and retention (deleting rotated
+// files beyond `keep`) run on this object's own low-priority thread, so
+// rotation never stalls the Logger worker. Pending jobs are finished on
+// destruction.
+class LogCompactor {
+ public:
+  explicit LogCompactor(LogCompactorOptions opt);
+  ~LogCompactor();
+
+  LogCompactor(const LogCompactor&) = delete;
+  LogCompactor& operator=(const LogCompactor&) = delete;
+
+  // Called from the writer when base_<index>.log has been closed.
+  void notify_rotated(int index);
+
+  // Blocks until every queued job has been processed (tests, shutdown).
+  void wait_idle();
+
+ private:
+  std::string file_name(int index) const;
+  bool compress_file(const std::string& path);
+  void apply_retention(int newest_rotated);
+  void run();
+
+  const LogCompactorOptions opt_;
+  int retained_floor_ = 0;  // lowest index that may still exist on disk
+
+  std::mutex m_;
+  std::condition_variable cv_;
+  std::condition_variable idle_cv_;
+  std::deque<int> jobs_;
+  bool busy_ = false;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+}  // namespace rover_logger
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <string_view>
 
 namespace rover_logger {
@@ -14,6 +15,9 @@ enum class LogLevel : int {
   FATAL = 5,
 };
 
+// Number of LogLevel values, for per-level tables.
+inline constexpr std::size_t kLevelCount = 6;
+
 // Allocation-free, header-only name lookup for fast printing/formatting.
 // constexpr => can be evaluated at compile-time and inlined aggressively.
 constexpr std::string_view to_string(LogLevel lv) {
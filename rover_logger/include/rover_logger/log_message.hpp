@@ -1,26 +1,128 @@
 #pragma once
 #include <chrono>
-#include <string>
-#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
 
 #include "rover_logger/log_level.hpp"
+#include "rover_logger/module_registry.hpp"
 
 namespace rover_logger {
 
+// Interned module name. Stores only the ModuleId; the text lives in the
+// ModuleRegistry and is handed out as a string_view.
+class ModuleName {
+ public:
+  ModuleName() = default;
+  explicit ModuleName(ModuleId id) : id_(id) {}
+  explicit ModuleName(std::string_view name)
+      : id_(ModuleRegistry::instance().intern(name)) {}
+
+  ModuleId id() const { return id_; }
+  std::string_view view() const {
+    return ModuleRegistry::instance().name(id_);
+  }
+  operator std::string_view() const { return view(); }
+
+  std::size_t size() const { return view().size(); }
+
+ private:
+  ModuleId id_ = ModuleRegistry::kUnknown;
+};
+
+// A module resolved once and reused, so hot call sites skip hashing the
+// name on every statement:
+//   static const ModuleHandle kDrive{"/drive"};
+//   RVLOG_INFO(logger, kDrive, "Speed=%d", speed);
+using ModuleHandle = ModuleName;
+
+// Message text with inline storage. Lines up to kInlineCapacity bytes need
+// no allocation; longer ones spill into a block from a shared pool.
+class MessageText {
+ public:
+  static constexpr std::size_t kInlineCapacity = 216;
+
+  MessageText() = default;
+  explicit MessageText(std::string_view s) { assign(s); }
+  MessageText(const MessageText& other);
+  MessageText(MessageText&& other) noexcept;
+  MessageText& operator=(const MessageText& other);
+  MessageText& operator=(MessageText&& other) noexcept;
+  ~MessageText() { release(); }
+
+  void assign(std::string_view s);
+
+  // Returns a writable buffer of at least n + 1 bytes (room for a trailing
+  // NUL, e.g. from vsnprintf) and sets the size to n.
+  char* resize_for_write(std::size_t n);
+  // Same, but keeps the first min(size(), n) bytes of the current text.
+  char* resize_keep(std::size_t n);
+  // Shrinks the logical size without touching the storage.
+  void truncate(std::size_t n) {
+    if (n < size_) size_ = static_cast<std::uint32_t>(n);
+  }
+
+  const char* data() const { return overflow_ != nullptr ? overflow_ : inline_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  bool spilled() const { return overflow_ != nullptr; }
+
+  std::string_view view() const { return {data(), size_}; }
+  operator std::string_view() const { return view(); }
+
+ private:
+  void release();
+
+  std::uint32_t size_ = 0;
+  std::uint32_t overflow_cap_ = 0;
+  char* overflow_ = nullptr;
+  char inline_[kInlineCapacity];
+};
+
 // Immutable log payload that all sinks see.
-struct LogMessage {
+//
+// A fixed-size, cache-line aligned record: the module is an interned id and
+// short text is stored inline, so building and queueing one does not touch
+// the heap. Sinks read module/text as string_views.
+struct alignas(64) LogMessage {
   using clock = std::chrono::system_clock;
 
-  LogLevel level;
-  std::string module;  // e.g. "/drive", "/vision"
-  std::string text;    // formatted log text
   clock::time_point ts;
+  LogLevel level;
+  ModuleName module;  // e.g. "/drive", "/vision"
+  // Deferred formatting: while set, text holds the captured printf
+  // arguments for this (static) format string, not the formatted line.
+  // The Logger worker formats and clears it before any sink sees it.
+  const char* fmt = nullptr;
+  MessageText text;   // formatted log text
 
-  LogMessage(LogLevel lvl, std::string mod, std::string msg)
-      : level(lvl),
-        module(std::move(mod)),
-        text(std::move(msg)),
-        ts(clock::now()) {}
+  LogMessage(LogLevel lvl, std::string_view mod, std::string_view msg)
+      : ts(clock::now()), level(lvl), module(mod), text(msg) {}
+
+  // Pre-interned module; text may be filled in afterwards.
+  LogMessage(LogLevel lvl, ModuleId mod, std::string_view msg = {})
+      : ts(clock::now()), level(lvl), module(mod), text(msg) {}
+
+  bool deferred() const { return fmt != nullptr; }
 };
 
+static_assert(sizeof(LogMessage) == 256, "LogMessage should stay 4 lines");
+
+inline bool operator==(const ModuleName& a, std::string_view b) {
+  return a.view() == b;
+}
+inline bool operator!=(const ModuleName& a, std::string_view b) {
+  return !(a == b);
+}
+inline bool operator==(const MessageText& a, std::string_view b) {
+  return a.view() == b;
+}
+inline bool operator!=(const MessageText& a, std::string_view b) {
+  return !(a == b);
+}
+
+std::ostream& operator<<(std::ostream& os, const ModuleName& m);
+std::ostream& operator<<(std::ostream& os, const MessageText& t);
+
 }  // namespace rover_logger
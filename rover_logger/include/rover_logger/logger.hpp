@@ -1,18 +1,27 @@
 #pragma once
+#include <array>
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
 #include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "rover_logger/bounded_queue.hpp"
+#include "rover_logger/coalescer.hpp"
+#include "rover_logger/config.hpp"
+#include "rover_logger/flight_recorder.hpp"
 #include "rover_logger/log_level.hpp"
 #include "rover_logger/log_message.hpp"
+#include "rover_logger/metrics.hpp"
+#include "rover_logger/module_registry.hpp"
+#include "rover_logger/rate_limiter.hpp"
 
 namespace rover_logger {
 
@@ -21,114 +30,353 @@ class ILogSink {
  public:
   virtual ~ILogSink() = default;
   virtual void write(const LogMessage& msg) = 0;
-  virtual void flush() {}
-};
 
-// Simple bounded queue with "drop oldest" semantics.
-template <class T>
-class BoundedQueue {
- public:
-  explicit BoundedQueue(std::size_t cap) : cap_(cap) {}
-
-  // Pushes an item; if full, drops the oldest.
-  // Returns true if an item was dropped.
-  bool push_drop_oldest(T&& item) {
-    std::scoped_lock lk(m_);
-    bool dropped = false;
-    if (q_.size() >= cap_) {
-      q_.pop_front();
-      dropped = true;
-    }
-    q_.emplace_back(std::move(item));
-    if (q_.size() > peak_) peak_ = q_.size();
-    cv_.notify_one();
-    return dropped;
+  // Writes count consecutive messages. Sinks that can coalesce output
+  // (one buffer, one syscall) override this; the default loops write().
+  virtual void write_batch(const LogMessage* msgs, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) write(msgs[i]);
   }
 
-  // Blocks until an item is available or stop is requested.
-  bool pop_wait(T& out) {
-    std::unique_lock lk(m_);
-    cv_.wait(lk, [&] { return stop_ || !q_.empty(); });
-    if (stop_ && q_.empty()) return false;
-    out = std::move(q_.front());
-    q_.pop_front();
-    return true;
-  }
-
-  void request_stop() {
-    {
-      std::scoped_lock lk(m_);
-      stop_ = true;
-    }
-    cv_.notify_all();
-  }
+  virtual void flush() {}
 
-  std::size_t peak() const {
-    std::scoped_lock lk(m_);
-    return peak_;
-  }
+  // flush() and make the output durable (fsync or equivalent) before
+  // returning. Used for messages at or above the emergency level.
+  virtual void sync() { flush(); }
 
- private:
-  const std::size_t cap_;
-  mutable std::mutex m_;
-  std::condition_variable cv_;
-  std::deque<T> q_;
-  bool stop_ = false;
-  std::size_t peak_ = 0;
+  // Short label for metrics ("terminal", "file", ...).
+  virtual const char* name() const { return "sink"; }
 };
 
 // Core async logger, independent of ROS.
 class Logger {
  public:
-  explicit Logger(std::size_t max_queue = 4096);
+  explicit Logger(std::size_t max_queue = 4096,
+                  QueueMode mode = QueueMode::Shared);
+  // Engine settings (queue size/mode, batching) from a loaded config.
+  // Levels and sinks are still applied by the caller.
+  explicit Logger(const LoggerConfig& cfg);
   ~Logger();
 
   Logger(const Logger&) = delete;
   Logger& operator=(const Logger&) = delete;
 
-  void add_sink(std::shared_ptr<ILogSink> sink) {
-    sinks_.push_back(std::move(sink));
-  }
+  // Attach sinks before logging starts. Under DispatchMode::PerSink this
+  // also starts the sink's writer thread. With coalescing enabled, repeated
+  // messages are collapsed (see Coalescer) on the thread that writes this
+  // sink, just before it does; summaries of idle windows are written when
+  // they fall due.
+  void add_sink(std::shared_ptr<ILogSink> sink,
+                const CoalesceConfig& coalesce = {});
 
   // Global minimum level. Everything below this is dropped.
-  void set_min_level(LogLevel lv) {
-    min_level_.store(lv, std::memory_order_relaxed);
-  }
+  void set_min_level(LogLevel lv);
 
   // Per-module configuration: /drive, /vision, /nav, etc.
+  // Names are '/'-separated paths; a module without its own override uses
+  // its longest configured ancestor, so "/vision" also covers
+  // "/vision/stereo/rectify".
   void set_module_level(const std::string& module, LogLevel lv);
   void clear_module_level(const std::string& module);
   void clear_all_module_levels();
   void apply_module_config(const std::unordered_map<std::string, LogLevel>& mods);
 
-  // Enqueue a message for processing by sinks.
+  // Per-module rate limits and sampling (see ModuleLimit), checked in
+  // submit() before a message is queued. Same longest-prefix rule as the
+  // levels; sub-modules share their ancestor's token bucket. Lock-free
+  // for producers, and free for modules without a limit.
+  void set_module_limit(const std::string& module, const ModuleLimit& lim);
+  void clear_module_limit(const std::string& module);
+  void apply_module_limits(
+      const std::unordered_map<std::string, ModuleLimit>& limits);
+
+  // Enqueue a message for processing by sinks. Messages at or above
+  // LoggerConfig::emergency_level are not queued: see submit().
   void log(LogMessage msg);
 
-  // Simple health metrics for debugging.
-  std::uint64_t dropped_total() const {
-    return dropped_total_.load(std::memory_order_relaxed);
+  // Global floor: false means no module could accept lv (one load +
+  // compare). The RVLOG_* macros use it when the module is given by name;
+  // with a ModuleHandle they check should_log() instead.
+  bool level_enabled(LogLevel lv) const {
+    return static_cast<int>(lv) >= floor_level_.load(std::memory_order_relaxed);
+  }
+
+  // Full global + per-module check. Lock-free: a module's level is one
+  // relaxed load from a table indexed by its interned id.
+  bool should_log(LogLevel lv, ModuleId module) const {
+    return level_enabled(lv) &&
+           static_cast<int>(lv) >= static_cast<int>(effective_min_level(module));
+  }
+  bool should_log(LogLevel lv, ModuleHandle module) const {
+    return should_log(lv, module.id());
+  }
+
+  // Enqueue without re-checking levels (caller already used should_log()).
+  //
+  // At or above emergency_level() the calling thread instead drains the
+  // queues, writes the message to every sink itself and sync()s them, so
+  // it is on disk before this returns and can never be dropped. Batches
+  // the worker or a sink thread had already taken may still land after
+  // it. Producers below that level never take a lock.
+  //
+  // Below it, module limits may hold the message back; see
+  // set_module_limit().
+  void submit(LogMessage msg);
+
+  // Flight recorder (LoggerConfig::flight_recorder). Messages that fail
+  // should_log() but are at or above the recorder's level still go to it:
+  // callers that filtered a message out pass it to record() instead of
+  // dropping it. Every submitted message is recorded too, and a FATAL one
+  // dumps the recorder before log() returns.
+  bool recording(LogLevel lv) const {
+    return static_cast<int>(lv) >= record_level_;
+  }
+  void record(const LogMessage& msg) {
+    if (recording(msg.level)) recorder_->record(msg);
   }
+  // Writes the recorder to its file now; false if disabled or on failure.
+  bool dump_flight_recorder(const char* reason = "requested");
+  FlightRecorder* flight_recorder() { return recorder_.get(); }
+
+  // Simple health metrics for debugging. Drops are messages lost before
+  // the worker saw them; under DispatchMode::PerSink a sink's own queue
+  // can also drop, which metrics_snapshot() reports per sink.
+  std::uint64_t dropped_total() const;
+  // Messages lost to a full queue, indexed by the lost message's level.
+  std::array<std::uint64_t, kLevelCount> dropped_by_level() const;
   std::uint64_t processed_total() const {
     return processed_total_.load(std::memory_order_relaxed);
   }
-  std::size_t queue_size_peak() const { return queue_.peak(); }
+  // Messages held back by module limits (not counted as drops).
+  std::uint64_t suppressed_total() const {
+    return suppressed_total_.load(std::memory_order_relaxed);
+  }
+  std::size_t queue_size_peak() const;
+
+  // Everything above plus latency/batch histograms, current queue depth
+  // and per-module traffic. Reads relaxed atomics only (O(modules)), so it
+  // is fine to call every few seconds from any thread. Rates are measured
+  // from the previous call, so use a single periodic caller.
+  LoggerMetrics metrics_snapshot();
+
+  QueueMode queue_mode() const { return mode_; }
+  OverflowPolicy overflow_policy() const { return overflow_; }
+  DispatchMode dispatch_mode() const { return dispatch_; }
+  LogLevel emergency_level() const { return emergency_level_; }
 
  private:
-  LogLevel effective_min_level(const std::string& module) const;
+  using Queue = BoundedQueue<LogMessage>;
+
+  struct DropCounters {
+    std::atomic<std::uint64_t> by_level[kLevelCount]{};
+
+    void add(LogLevel lv) {
+      const auto i = static_cast<std::size_t>(lv);
+      by_level[i < kLevelCount ? i : kLevelCount - 1].fetch_add(
+          1, std::memory_order_relaxed);
+    }
+  };
+
+  // A producer thread's private queue (QueueMode::PerThread). Drops are
+  // counted here so producers never share a counter cache line.
+  struct ProducerSlot {
+    explicit ProducerSlot(std::size_t cap, Doorbell* bell)
+        : queue(cap, bell) {}
+
+    Queue queue;
+    DropCounters drops;
+    std::atomic<bool> orphaned{false};  // owning thread has exited
+  };
+
+  // Output written but not flushed yet, and since when.
+  struct FlushState {
+    bool pending = false;
+    std::chrono::steady_clock::time_point since;
+
+    void mark() {
+      if (pending) return;
+      pending = true;
+      since = std::chrono::steady_clock::now();
+    }
+  };
+
+  // An attached sink. Under DispatchMode::PerSink it also has its own
+  // queue and writer thread; the worker only copies messages into it.
+  struct SinkSlot {
+    explicit SinkSlot(std::shared_ptr<ILogSink> s) : sink(std::move(s)) {}
+
+    std::shared_ptr<ILogSink> sink;
+    std::mutex write_mutex;  // PerSink writer thread vs. write_through()
+    Histogram write_ns;
+    std::atomic<std::uint64_t> written{0};
+
+    // Optional; used by whichever thread writes the sink.
+    std::unique_ptr<Coalescer> coalescer;
+    std::vector<LogMessage> coalesce_out;
+
+    // PerSink only. flush and latency_sample belong to the writer thread.
+    std::unique_ptr<Queue> queue;
+    DropCounters drops;
+    Histogram enqueue_to_sink_ns;
+    std::uint64_t latency_sample = 0;
+    FlushState flush;
+    std::thread thread;
+  };
+
+  // A configured ModuleLimit. Limiters are never freed before the Logger,
+  // so producers can use one without a lock while it is being replaced.
+  struct ModuleLimiter {
+    explicit ModuleLimiter(const ModuleLimit& lim);
+    bool admit(const LogMessage& msg);  // false => suppressed
+
+    // Call sites hash into this many sampling counters.
+    static constexpr std::size_t kSampleSites = 64;
+    const std::uint64_t sample;
+    std::optional<TokenBucket> bucket;
+    std::atomic<std::uint64_t> site_counts[kSampleSites]{};
+    SuppressedCount suppressed;
+  };
+
+  // Marks a module with no override in module_levels_.
+  static constexpr std::int8_t kInheritLevel = -1;
+
+  // Resolved levels are cached per module, tagged with the levels_gen_
+  // they were computed under; any override change bumps the generation.
+  LogLevel effective_min_level(ModuleId module) const {
+    if (module >= ModuleRegistry::kMaxModules) module = ModuleRegistry::kUnknown;
+    const std::uint64_t gen = levels_gen_.load(std::memory_order_acquire);
+    const std::uint64_t cached =
+        resolved_levels_[module].load(std::memory_order_relaxed);
+    std::int8_t lv;
+    if ((cached >> 8) == gen) {
+      lv = static_cast<std::int8_t>(cached & 0xff);
+    } else {
+      lv = resolve_module_level(module);
+      resolved_levels_[module].store(
+          (gen << 8) | static_cast<std::uint8_t>(lv), std::memory_order_relaxed);
+    }
+    if (lv != kInheritLevel) return static_cast<LogLevel>(lv);
+    return min_level_.load(std::memory_order_relaxed);
+  }
+  std::int8_t resolve_module_level(ModuleId module) const;
+  // The limiter that applies to module, or nullptr. Cached per module like
+  // the levels, under limits_gen_.
+  ModuleLimiter* module_limiter(ModuleId module) const;
+  void store_module_limit_locked(ModuleId module, const ModuleLimit* lim);
+  void publish_module_limits_locked();  // after changing module_limits_
+  void store_module_level_locked(ModuleId module, std::int8_t lv);
+  void publish_module_levels_locked();  // after changing module_levels_
+  void recompute_floor_locked();
+  ProducerSlot& producer_slot();
+  // Applies overflow_ when pushing into q.
+  void enqueue(Queue& q, DropCounters& drops, LogMessage&& msg);
+  void enqueue(LogMessage&& msg);  // into this thread's queue
   void worker();
+  void worker_per_thread();
+  void dispatch(std::vector<LogMessage>& batch);
+  void count_module(const LogMessage& msg);  // under dispatch_mutex_
+  // Emergency path (see submit()). drain_queues_locked() dispatches what
+  // the producer queues hold right now, in timestamp order.
+  void write_through(LogMessage msg);
+  void drain_queues_locked();
+  void write_to_sink(SinkSlot& s, const LogMessage* msgs, std::size_t count);
+  // write_to_sink() through the sink's coalescer, if it has one.
+  void deliver(SinkSlot& s, const LogMessage* msgs, std::size_t count);
+  // Writes the coalescer summaries due now (all of them if all); true if
+  // anything was written.
+  bool deliver_due(SinkSlot& s, bool all);
+  void deliver_due_locked();  // DispatchMode::Inline worker, every sink
+  void sink_worker(SinkSlot& s);  // PerSink writer thread
+  void stop_sink_workers();
+  // Periodic flush of buffered sinks (see LoggerConfig::flush_interval_ms).
+  std::chrono::microseconds flush_wait(const FlushState& st) const;
+  // flush_wait(), or sooner if a coalescer summary falls due first: s's,
+  // or with nullptr every sink's that the worker writes.
+  std::chrono::microseconds idle_wait(const FlushState& st,
+                                      const SinkSlot* s) const;
+  bool flush_due(FlushState& st) const;  // true (and clears st) when due
+  void flush_if_due();                   // DispatchMode::Inline worker
 
-  std::vector<std::shared_ptr<ILogSink>> sinks_;
-  BoundedQueue<LogMessage> queue_;
+  const QueueMode mode_;
+  const OverflowPolicy overflow_;
+  const std::chrono::microseconds block_timeout_;
+  const DispatchMode dispatch_;
+  const std::size_t sink_queue_cap_;
+  const std::size_t queue_cap_;
+  const std::size_t batch_max_;
+  const std::chrono::microseconds batch_linger_;
+  const std::chrono::milliseconds flush_interval_;
+  const LogLevel emergency_level_;
+  const std::uint64_t id_;  // tells Logger instances apart in thread caches
+  // kLevelCount when there is no recorder, so recording() is always false.
+  const int record_level_;
+  const bool dump_on_exit_;
+  std::unique_ptr<FlightRecorder> recorder_;
+
+  std::vector<std::unique_ptr<SinkSlot>> sinks_;
+  Queue queue_;
   std::thread worker_;
   std::atomic<bool> running_{true};
+  // Held by the worker around each dispatch, and by write_through() so it
+  // can dispatch in the worker's place. Guards the worker-only state.
+  std::mutex dispatch_mutex_;
+  std::string format_scratch_;  // worker-only, for deferred formatting
+  FlushState flush_;            // worker-only, DispatchMode::Inline
+
+  // Per-thread mode: every slot shares bell_ so the worker sleeps once.
+  Doorbell bell_;
+  mutable std::mutex producers_mutex_;
+  std::vector<std::shared_ptr<ProducerSlot>> producers_;
+  std::atomic<std::uint64_t> producers_version_{0};
+  // From reaped slots, guarded by producers_mutex_.
+  std::array<std::uint64_t, kLevelCount> retired_dropped_{};
+  std::size_t retired_peak_ = 0;
 
   std::atomic<LogLevel> min_level_{LogLevel::TRACE};
+  // min(global level, every module override, flight recorder level);
+  // recomputed on any change.
+  std::atomic<int> floor_level_{static_cast<int>(LogLevel::TRACE)};
 
+  // Writers (set/clear/apply) serialize on modules_mutex_ and keep the
+  // authoritative map; readers only ever touch the atomic tables below,
+  // which writers update entry by entry, so a reconfiguration never blocks
+  // log().
   mutable std::mutex modules_mutex_;
-  std::unordered_map<std::string, LogLevel> module_min_levels_;
+  std::unordered_map<ModuleId, LogLevel> module_min_levels_;
+  std::atomic<std::int8_t> module_levels_[ModuleRegistry::kMaxModules];
+
+  // Inherited levels: (generation << 8) | level, filled in lazily by readers.
+  std::atomic<std::uint64_t> levels_gen_{1};
+  mutable std::atomic<std::uint64_t> resolved_levels_[ModuleRegistry::kMaxModules];
 
-  std::atomic<std::uint64_t> dropped_total_{0};
+  // Module limits, same scheme: the map and limiter_store_ are guarded by
+  // modules_mutex_, producers read the tables. Resolved entries are
+  // (generation << 16) | (owning module + 1), 0 for none.
+  std::unordered_map<ModuleId, ModuleLimit> module_limits_;
+  std::vector<std::unique_ptr<ModuleLimiter>> limiter_store_;
+  std::atomic<ModuleLimiter*> module_limiters_[ModuleRegistry::kMaxModules];
+  std::atomic<std::uint64_t> limits_gen_{1};
+  mutable std::atomic<std::uint64_t> resolved_limiters_[ModuleRegistry::kMaxModules];
+  std::atomic<bool> limits_active_{false};  // any limit configured
+  std::atomic<std::uint64_t> suppressed_total_{0};
+
+  DropCounters drops_;  // shared queue
   std::atomic<std::uint64_t> processed_total_{0};
+
+  // Metrics. Written by the worker (or write_through()) under
+  // dispatch_mutex_; read by metrics_snapshot().
+  // One in kLatencySampleEvery messages feeds enqueue_to_sink_ns_.
+  static constexpr std::uint64_t kLatencySampleEvery = 8;
+  Histogram enqueue_to_sink_ns_;
+  Histogram batch_size_;
+  std::uint64_t latency_sample_ = 0;
+  std::atomic<std::uint64_t> module_msgs_[ModuleRegistry::kMaxModules];
+  std::atomic<std::uint64_t> module_bytes_[ModuleRegistry::kMaxModules];
+
+  // metrics_snapshot() state, for rates.
+  std::mutex metrics_mutex_;
+  std::chrono::steady_clock::time_point last_snapshot_;
+  std::vector<std::uint64_t> last_module_msgs_;
+  std::vector<std::uint64_t> last_module_bytes_;
 };
 
 }  // namespace rover_logger
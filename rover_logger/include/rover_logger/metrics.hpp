@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rover_logger/log_level.hpp"
+
+namespace rover_logger {
+
+// Percentiles of a Histogram at the moment it was read.
+struct HistogramSummary {
+  std::uint64_t count = 0;
+  double mean = 0;
+  std::uint64_t p50 = 0;
+  std::uint64_t p90 = 0;
+  std::uint64_t p99 = 0;
+  std::uint64_t p999 = 0;
+  std::uint64_t max = 0;
+};
+
+// HDR-style histogram of non-negative integers (nanoseconds, sizes, ...).
+//
+// Log-linear buckets: 16 linear sub-buckets per power of two, so any
+// reported percentile is within ~6% of the true value, over the full
+// 64-bit range in ~8 KB. record() is a few relaxed atomic adds and never
+// blocks; summary() can run concurrently with it from any thread.
+class Histogram {
+ public:
+  static constexpr int kSubBits = 4;
+  static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBits;
+  static constexpr std::size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+  Histogram();
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  void record(std::uint64_t value);
+  HistogramSummary summary() const;
+
+  static std::size_t bucket_index(std::uint64_t value);
+  // Largest value that lands in bucket idx.
+  static std::uint64_t bucket_upper(std::size_t idx);
+
+ private:
+  std::atomic<std::uint64_t> buckets_[kBuckets];
+  std::atomic<std::uint64_t> count_{0};
+  std::atomic<std::uint64_t> sum_{0};
+  std::atomic<std::uint64_t> max_{0};
+};
+
+struct SinkMetrics {
+  std::string name;               // ILogSink::name()
+  HistogramSummary write_ns;      // time spent in one write_batch() call
+  std::uint64_t written = 0;      // messages handed to write_batch()
+  std::uint64_t coalesced = 0;    // repeats collapsed before writing
+  // LogMessage::ts -> this sink, sampled. Same as the Logger-wide figure
+  // unless dispatch is DispatchMode::PerSink.
+  HistogramSummary enqueue_to_sink_ns;
+  // DispatchMode::PerSink only: the sink's own queue.
+  std::uint64_t dropped = 0;
+  std::size_t queue_depth = 0;
+  std::size_t queue_peak = 0;
+};
+
+struct ModuleMetrics {
+  std::string module;
+  std::uint64_t messages = 0;     // delivered since the Logger started
+  std::uint64_t bytes = 0;        // message text bytes, same
+  double messages_per_sec = 0;    // over LoggerMetrics::interval_sec
+  double bytes_per_sec = 0;
+};
+
+// Returned by Logger::metrics_snapshot().
+struct LoggerMetrics {
+  std::chrono::system_clock::time_point taken;
+  // Rates cover the time since the previous snapshot (or since the
+  // Logger started, for the first one).
+  double interval_sec = 0;
+
+  std::uint64_t processed_total = 0;
+  std::uint64_t dropped_total = 0;
+  std::array<std::uint64_t, kLevelCount> dropped_by_level{};  // by LogLevel
+  std::uint64_t suppressed_total = 0;  // held back by module limits
+  std::size_t queue_depth = 0;     // messages waiting right now
+  std::size_t queue_capacity = 0;  // per producer thread in PerThread mode
+  std::size_t queue_peak = 0;
+
+  HistogramSummary enqueue_to_sink_ns;  // LogMessage::ts -> sink, sampled
+  HistogramSummary batch_size;
+  std::vector<SinkMetrics> sinks;       // in add_sink() order
+  // Modules with any traffic, busiest (by current message rate) first.
+  std::vector<ModuleMetrics> modules;
+};
+
+// One-line JSON rendering, e.g. for the ROS bridge's metrics topic.
+std::string metrics_to_json(const LoggerMetrics& m);
+
+}  // namespace rover_logger
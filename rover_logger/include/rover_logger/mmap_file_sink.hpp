@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "rover_logger/json_formatter.hpp"
+#include "rover_logger/log_message.hpp"
+#include "rover_logger/logger.hpp"
+
+namespace rover_logger {
+
+struct MmapFileSinkOptions {
+  std::string base_filename;               // base_0.log, base_1.log, ...
+  std::size_t segment_bytes = 64u << 20;   // size of each preallocated file
+  TimestampFormat timestamp = TimestampFormat::Iso8601Millis;
+  // After a segment could not be prepared, wait this long before the
+  // next attempt.
+  std::chrono::milliseconds retry_interval{1000};
+};
+
+// JSON-lines sink for very high-rate streams.
+//
+// Output goes into fixed-size segment files that are preallocated
+// (posix_fallocate) and mapped; a write is a memcpy at a bump pointer.
+// A helper thread maps the next segment ahead of time and retires full
+// ones (msync, trim the unused tail, unmap), so rotation on the logging
+// thread is a pointer swap. A line that does not fit in the rest of a
+// segment starts the next one; lines longer than a segment are truncated.
+//
+// If a segment cannot be preallocated (disk full, quota) output is dropped
+// and counted, without waiting, and the helper tries again at most once
+// per retry_interval until it prepares one.
+//
+// After a crash the live segment may end in NUL padding; it is trimmed on
+// clean shutdown.
+class MmapFileSink final : public ILogSink {
+ public:
+  explicit MmapFileSink(MmapFileSinkOptions opt);
+  ~MmapFileSink() override;
+
+  MmapFileSink(const MmapFileSink&) = delete;
+  MmapFileSink& operator=(const MmapFileSink&) = delete;
+
+  void write(const LogMessage& msg) override;
+  void write_batch(const LogMessage* msgs, std::size_t count) override;
+  // Schedules write-back of everything written so far (msync MS_ASYNC).
+  void flush() override;
+  // Writes back the live segment and waits for it (msync MS_SYNC).
+  void sync() override;
+  const char* name() const override { return "mmap_file"; }
+
+  // Bytes lost because no segment was mapped or a line was truncated.
+  std::uint64_t dropped_bytes() const {
+    return dropped_bytes_.load(std::memory_order_relaxed);
+  }
+  // Segments that could not be created, preallocated or mapped.
+  std::uint64_t prepare_failures() const {
+    return prepare_failures_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Segment {
+    int fd = -1;
+    char* base = nullptr;
+    std::size_t size = 0;
+    std::size_t used = 0;
+    std::size_t synced = 0;  // bytes already handed to msync
+    int index = 0;
+  };
+
+  std::string file_name(int index) const;
+  std::optional<Segment> map_segment(int index) const;
+  static void retire(Segment& seg);
+
+  void append(const char* data, std::size_t len);
+  void rotate();
+  void note_prepare_failure();
+  void run();
+
+  const MmapFileSinkOptions opt_;
+  TimestampFormatter ts_;
+  std::string line_buf_;  // reused across writes
+
+  std::mutex write_m_;  // write/flush
+  Segment active_;
+
+  // Helper thread state.
+  std::mutex m_;
+  std::condition_variable cv_;
+  std::condition_variable ready_cv_;
+  std::optional<Segment> next_;
+  bool next_requested_ = false;
+  bool prepare_failed_ = false;  // the last attempt failed; see retry_at_
+  std::chrono::steady_clock::time_point retry_at_;
+  int next_index_ = 0;
+  std::deque<Segment> retiring_;
+  bool stop_ = false;
+  std::thread thread_;
+
+  std::atomic<std::uint64_t> dropped_bytes_{0};
+  std::atomic<std::uint64_t> prepare_failures_{0};
+};
+
+}  // namespace rover_logger
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace rover_logger {
+
+// Small integer standing in for a module name ("/drive", "/vision", ...).
+using ModuleId = std::uint32_t;
+
+// Process-wide interning table: module name <-> ModuleId.
+//
+// Lookups (both directions) are lock-free; only the first sighting of a new
+// name takes a mutex. Names are never removed, so ids and the string_views
+// returned by name() stay valid for the life of the process.
+class ModuleRegistry {
+ public:
+  static constexpr std::size_t kMaxModules = 4096;
+  // Reserved id, named "?". Returned once the table is full.
+  static constexpr ModuleId kUnknown = 0;
+
+  static ModuleRegistry& instance();
+
+  ModuleId intern(std::string_view name);
+  // Like intern() but never inserts; kUnknown if name was never interned.
+  ModuleId find(std::string_view name) const;
+  std::string_view name(ModuleId id) const;
+  std::size_t size() const { return count_.load(std::memory_order_acquire); }
+
+  ModuleRegistry(const ModuleRegistry&) = delete;
+  ModuleRegistry& operator=(const ModuleRegistry&) = delete;
+
+ private:
+  ModuleRegistry();
+
+  // Open-addressed hash index; 0 means empty (kUnknown is never indexed).
+  static constexpr std::size_t kSlots = kMaxModules * 2;
+
+  std::atomic<ModuleId> slots_[kSlots];
+  std::atomic<const std::string*> names_[kMaxModules];
+  std::atomic<std::size_t> count_{0};
+
+  std::mutex insert_mutex_;
+  std::deque<std::string> storage_;  // stable addresses for names_
+};
+
+}  // namespace rover_logger
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace rover_logger {
+
+inline std::int64_t steady_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Lock-free token bucket: up to burst messages at once, refilled at rate
+// per second. Kept as a single "theoretical arrival time" (GCRA), so
+// taking a token is one CAS.
+class TokenBucket {
+ public:
+  TokenBucket(double rate, std::size_t burst)
+      : interval_ns_(static_cast<std::int64_t>(1e9 / rate)),
+        tolerance_ns_(interval_ns_ *
+                      static_cast<std::int64_t>(std::max<std::size_t>(burst, 1) - 1)) {}
+
+  bool try_take(std::int64_t now_ns) {
+    std::int64_t tat = tat_ns_.load(std::memory_order_relaxed);
+    for (;;) {
+      const std::int64_t base = std::max(tat, now_ns);
+      if (base - now_ns > tolerance_ns_) return false;
+      if (tat_ns_.compare_exchange_weak(tat, base + interval_ns_,
+                                        std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+
+ private:
+  const std::int64_t interval_ns_;
+  const std::int64_t tolerance_ns_;  // (burst - 1) intervals
+  std::atomic<std::int64_t> tat_ns_{0};
+};
+
+// Counts messages a limiter held back, to be reported as one
+// "suppressed N similar messages" line at most once per kIntervalNs.
+class SuppressedCount {
+ public:
+  static constexpr std::int64_t kIntervalNs = 1'000'000'000;
+
+  void add() { count_.fetch_add(1, std::memory_order_relaxed); }
+  bool pending() const { return count_.load(std::memory_order_relaxed) != 0; }
+
+  // The count to report now (and reset), or 0 if there is none or the
+  // last report was too recent. Only one concurrent caller gets it.
+  std::uint64_t take(std::int64_t now_ns) {
+    if (!pending()) return 0;
+    std::int64_t next = next_ns_.load(std::memory_order_relaxed);
+    if (now_ns < next ||
+        !next_ns_.compare_exchange_strong(next, now_ns + kIntervalNs,
+                                          std::memory_order_relaxed)) {
+      return 0;
+    }
+    return count_.exchange(0, std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<std::uint64_t> count_{0};
+  std::atomic<std::int64_t> next_ns_{0};
+};
+
+// State of one RVLOG_*_EVERY_N / RVLOG_*_EVERY_SEC statement; the macros
+// keep one as a function-local static per call site.
+class CallSiteLimiter {
+ public:
+  constexpr CallSiteLimiter() = default;
+
+  // True for the 1st, (n+1)th, (2n+1)th, ... call.
+  bool every_n(std::uint64_t n) {
+    if (n <= 1 || count_.fetch_add(1, std::memory_order_relaxed) % n == 0) {
+      return true;
+    }
+    suppressed_.add();
+    return false;
+  }
+
+  // True at most once per period.
+  bool every(double seconds) {
+    const std::int64_t now = steady_now_ns();
+    std::int64_t next = next_ns_.load(std::memory_order_relaxed);
+    if (now >= next &&
+        next_ns_.compare_exchange_strong(
+            next, now + static_cast<std::int64_t>(seconds * 1e9),
+            std::memory_order_relaxed)) {
+      return true;
+    }
+    suppressed_.add();
+    return false;
+  }
+
+  std::uint64_t take_suppressed() {
+    return suppressed_.pending() ? suppressed_.take(steady_now_ns()) : 0;
+  }
+
+ private:
+  std::atomic<std::uint64_t> count_{0};
+  std::atomic<std::int64_t> next_ns_{0};
+  SuppressedCount suppressed_;
+};
+
+}  // namespace rover_logger
@@ -11,10 +11,13 @@
 #include "rover_logger/sink_factory.hpp"
 
 #include "rover_msgs/msg/log_entry.hpp"
+#include "std_msgs/msg/string.hpp"
 
 namespace rover_logger {
 
 // Node that subscribes to /rover/log and routes everything into Logger.
+// With metrics_interval_ms set, it also publishes metrics_to_json() of the
+// logger on /rover/logger/metrics.
 class Ros2LogBridge : public rclcpp::Node {
  public:
   Ros2LogBridge(const LoggerConfig& cfg,
@@ -23,11 +26,14 @@ class Ros2LogBridge : public rclcpp::Node {
 
  private:
   void handle_log_msg(const rover_msgs::msg::LogEntry::SharedPtr msg);
+  void publish_metrics();
 
   Logger logger_;
   std::vector<std::shared_ptr<ILogSink>> sinks_;
 
   rclcpp::Subscription<rover_msgs::msg::LogEntry>::SharedPtr sub_;
+  rclcpp::Publisher<std_msgs::msg::String>::SharedPtr metrics_pub_;
+  rclcpp::TimerBase::SharedPtr metrics_timer_;
 };
 
 }  // namespace rover_logger
@@ -16,4 +16,7 @@ std::shared_ptr<ILogSink> make_sink(const SinkConfig& cfg);
 // Build all sinks described in LoggerConfig.
 std::vector<std::shared_ptr<ILogSink>> make_all_sinks(const LoggerConfig& cfg);
 
+// The Logger-side options of a sink, for Logger::add_sink().
+CoalesceConfig coalesce_config(const SinkConfig& cfg);
+
 }  // namespace rover_logger
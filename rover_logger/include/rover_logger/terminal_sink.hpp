@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <ctime>
 #include <mutex>
 #include <string>
 
@@ -10,19 +12,36 @@
 namespace rover_logger {
 
 // Writes human-readable logs to stdout with optional ANSI colours.
+//
+// Lines are formatted into a reusable buffer and each batch goes out with a
+// single write(2). Colours are dropped automatically when the output is not
+// a terminal (pipes, files, journald).
 class TerminalSink : public ILogSink {
  public:
-  explicit TerminalSink(bool colorize);
+  // fd defaults to stdout; any other descriptor is written to but not owned.
+  explicit TerminalSink(bool colorize, int fd = -1);
 
   // Core logging hook used by Logger
   void write(const LogMessage& msg) override;
+  void write_batch(const LogMessage* msgs, std::size_t count) override;
   void flush() override {}
+  const char* name() const override { return "terminal"; }
+
+  bool colorized() const { return colorize_; }
 
  private:
   static const char* color_for(LogLevel lv);
-  static std::string format_ts(const LogMessage::clock::time_point& tp);
+  // Appends "YYYY-MM-DD HH:MM:SS.mmm" (local time). The date/time part is
+  // cached and only rebuilt when the second changes.
+  void format_ts(std::string& out, const LogMessage::clock::time_point& tp);
+  void append_line(const LogMessage& msg);
+  void write_out();
 
+  int fd_;
   bool colorize_;
+  std::string buf_;  // reused across writes
+  std::time_t ts_cached_sec_ = -1;
+  char ts_cached_[24] = {};
   std::mutex m_;
 };
 
@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rover_logger/json_formatter.hpp"
+#include "rover_logger/log_message.hpp"
+#include "rover_logger/logger.hpp"
+
+namespace rover_logger {
+
+struct UringFileSinkOptions {
+  std::string base_filename;               // base_0.log, base_1.log, ...
+  std::size_t rotation_bytes = 500u << 20;
+  std::size_t buffer_bytes = 256u << 10;   // size of each registered buffer
+  std::size_t buffer_count = 8;            // max writes in flight
+  LogLevel sync_level = LogLevel::ERROR;   // batches at/above get a linked fsync
+  TimestampFormat timestamp = TimestampFormat::Iso8601Millis;
+  bool use_uring = true;                   // false forces the blocking writer
+};
+
+// JSON-lines file sink that never waits for the disk on the logging thread.
+//
+// Each batch is formatted into one of a fixed set of buffers (registered
+// with the kernel) and submitted to io_uring as a write at an explicit file
+// offset, followed by a linked fsync when the batch holds a message at or
+// above sync_level. Completions are reaped opportunistically on later
+// writes. When every buffer is still in flight the batch is dropped and
+// counted rather than blocking. A short write is resubmitted for the rest
+// of the buffer. Failed writes are counted; once nothing is in flight and
+// nothing after the first failed byte reached the file, appending resumes
+// from that byte, so the file does not keep a NUL-filled hole.
+//
+// Rotation follows FileRotationSink's rule (base_N.log; the line that
+// crosses rotation_bytes stays in the old file); the old file is closed
+// once its last write completes.
+//
+// If io_uring is unavailable (old kernel, seccomp, non-Linux) the same
+// buffers are written synchronously with write(2).
+class UringFileSink final : public ILogSink {
+ public:
+  struct Stats {
+    std::uint64_t inflight_bytes;
+    std::uint64_t completed_bytes;
+    std::uint64_t dropped_bytes;  // no free buffer
+    std::uint64_t failed_bytes;   // write errors
+    std::uint64_t failed_syncs;   // fsync / fdatasync errors
+  };
+
+  explicit UringFileSink(UringFileSinkOptions opt);
+  ~UringFileSink() override;
+
+  UringFileSink(const UringFileSink&) = delete;
+  UringFileSink& operator=(const UringFileSink&) = delete;
+
+  void write(const LogMessage& msg) override;
+  void write_batch(const LogMessage* msgs, std::size_t count) override;
+  // Submits the partially filled buffer, if any, and reaps completions.
+  void flush() override;
+  // Submits the partial buffer, waits for every write in flight, then
+  // fdatasyncs the current file.
+  void sync() override;
+  const char* name() const override { return "uring_file"; }
+
+  Stats stats() const;
+  bool using_uring() const { return ring_ != nullptr; }
+
+ private:
+  class Ring;  // raw io_uring wrapper, see the .cpp
+
+  struct Buffer {
+    std::unique_ptr<char[]> data;
+    std::size_t len = 0;
+    std::size_t done = 0;      // bytes already written (short writes)
+    std::uint64_t offset = 0;  // file offset of data[0]
+    int file = -1;             // index into files_
+    bool sync = false;         // an fsync is linked behind the write
+    bool inflight = false;
+  };
+  struct File {
+    int fd = -1;
+    int pending = 0;       // submitted writes/fsyncs not yet completed
+    bool current = false;  // still being appended to
+    std::uint64_t written_end = 0;  // end of the furthest completed write
+    std::uint64_t hole = ~std::uint64_t{0};  // first byte a write failed at
+  };
+
+  bool open_next_file();
+  void close_file_if_done(int file);
+  int acquire_buffer();
+  void append_line(const LogMessage& msg, LogLevel& highest);
+  void submit_current(bool sync);
+  void push_buffer(int bi);
+  void reap(bool wait_all);
+
+  const UringFileSinkOptions opt_;
+  TimestampFormatter ts_;
+  std::string line_buf_;
+
+  std::mutex m_;
+  std::unique_ptr<Ring> ring_;
+  std::vector<Buffer> buffers_;
+  std::vector<int> free_buffers_;
+  std::vector<File> files_;
+  int current_file_ = -1;
+  int file_index_ = 0;
+  std::uint64_t file_offset_ = 0;  // next write offset in the current file
+  int current_buf_ = -1;
+
+  std::atomic<std::uint64_t> inflight_bytes_{0};
+  std::atomic<std::uint64_t> completed_bytes_{0};
+  std::atomic<std::uint64_t> dropped_bytes_{0};
+  std::atomic<std::uint64_t> failed_bytes_{0};
+  std::atomic<std::uint64_t> failed_syncs_{0};
+};
+
+}  // namespace rover_logger
@@ -1,44 +1,157 @@
 #include "rover_logger/FileRotationSink.h"
 
-#include <filesystem>
-#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-FileRotationSink::FileRotationSink(const std::string& base, std::size_t maxSize)
-    : baseFilename(base),
+#include <cerrno>
+#include <utility>
+
+FileRotationSink::FileRotationSink(const std::string& base, std::size_t maxSize,
+                                   std::size_t bufferSize)
+    : fd(-1),
+      baseFilename(base),
       maxFileSize(maxSize),
-      fileIndex(0) {
+      fileIndex(0),
+      fileSize(0),
+      bufferCapacity(bufferSize) {
+  buffer.reserve(bufferCapacity);
   // Initial file: base_0.log
-  currentFile.open(baseFilename + "_0.log", std::ios::out | std::ios::trunc);
+  openFile(true);
 }
 
 FileRotationSink::~FileRotationSink() {
-  if (currentFile.is_open()) {
-    currentFile.close();
+  flush();
+  closeFile();
+}
+
+std::string FileRotationSink::fileName(int index) const {
+  return baseFilename + "_" + std::to_string(index) + ".log";
+}
+
+void FileRotationSink::openFile(bool truncate) {
+  const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND);
+  fd = ::open(fileName(fileIndex).c_str(), flags, 0644);
+  fileSize = 0;
+  if (fd >= 0 && !truncate) {
+    struct stat st {};
+    if (::fstat(fd, &st) == 0) fileSize = static_cast<std::size_t>(st.st_size);
   }
 }
 
-void FileRotationSink::rotate() {
-  if (currentFile.is_open()) {
-    currentFile.close();
+void FileRotationSink::closeFile() {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
   }
+}
+
+bool FileRotationSink::ensureOpen() {
+  if (fd < 0) {
+    openFile(false);
+  }
+  return fd >= 0;
+}
+
+void FileRotationSink::rotate() {
+  flush();
+  closeFile();
+  const int closedIndex = fileIndex;
   ++fileIndex;
-  std::string newFilename =
-      baseFilename + "_" + std::to_string(fileIndex) + ".log";
-  currentFile.open(newFilename, std::ios::out | std::ios::trunc);
+  openFile(true);
+  if (onRotated) onRotated(closedIndex);
 }
 
-void FileRotationSink::write(const std::string& message) {
-  if (!currentFile.is_open()) {
-    currentFile.open(baseFilename + "_" + std::to_string(fileIndex) + ".log",
-                     std::ios::out | std::ios::app);
-    if (!currentFile.is_open()) {
+void FileRotationSink::setRotateCallback(std::function<void(int)> callback) {
+  onRotated = std::move(callback);
+}
+
+void FileRotationSink::writeAll(const char* data, std::size_t len) {
+  while (len > 0 && fd >= 0) {
+    const ssize_t n = ::write(fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return;  // disk full / I/O error: drop rather than stall logging
+    }
+    data += n;
+    len -= static_cast<std::size_t>(n);
+  }
+}
+
+void FileRotationSink::append(const char* data, std::size_t len) {
+  if (buffer.size() + len > bufferCapacity) {
+    flush();
+    if (len > bufferCapacity) {
+      writeAll(data, len);
+      fileSize += len;
       return;
     }
   }
+  buffer.append(data, len);
+  fileSize += len;
+}
+
+void FileRotationSink::flush() {
+  if (buffer.empty()) return;
+  writeAll(buffer.data(), buffer.size());
+  buffer.clear();
+}
+
+void FileRotationSink::sync() {
+  flush();
+  if (fd >= 0) ::fsync(fd);
+}
+
+void FileRotationSink::write(const std::string& message) {
+  if (!ensureOpen()) {
+    return;
+  }
+
+  append(message.data(), message.size());
+  append("\n", 1);
+
+  if (fileSize >= maxFileSize) {
+    rotate();
+  }
+}
+
+void FileRotationSink::writeBlock(const std::string& block) {
+  if (!ensureOpen()) {
+    return;
+  }
+
+  std::size_t chunkStart = 0;
+  std::size_t pos = 0;
+  std::size_t size = fileSize;
+  while (pos < block.size()) {
+    std::size_t eol = block.find('\n', pos);
+    eol = (eol == std::string::npos) ? block.size() : eol + 1;
+    size += eol - pos;
+    pos = eol;
+
+    // Same rule as write(): the line that crosses the limit stays in the
+    // current file, then we rotate.
+    if (size >= maxFileSize) {
+      append(block.data() + chunkStart, pos - chunkStart);
+      rotate();
+      chunkStart = pos;
+      size = 0;
+    }
+  }
+
+  if (chunkStart < block.size()) {
+    append(block.data() + chunkStart, block.size() - chunkStart);
+  }
+}
+
+void FileRotationSink::writeRecord(const char* data, std::size_t len) {
+  if (!ensureOpen()) {
+    return;
+  }
 
-  currentFile << message << std::endl;
+  append(data, len);
 
-  if (currentFile.tellp() >= static_cast<std::streampos>(maxFileSize)) {
+  if (fileSize >= maxFileSize) {
     rotate();
   }
 }
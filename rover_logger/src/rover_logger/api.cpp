@@ -2,31 +2,45 @@
 
 #include <cstdarg>
 #include <cstdio>
-#include <vector>
 
 #include "rover_logger/log_message.hpp"
 
 namespace rover_logger {
 
-// Internal printf formatter with stack buffer + fallback.
-static std::string vformat(const char* fmt, va_list args) {
-  char buf[256];
+// Internal printf formatter: formats straight into the message's inline
+// buffer, and only for long lines a second time into an overflow block.
+static void vformat(MessageText& out, const char* fmt, va_list args) {
+  char* buf = out.resize_for_write(MessageText::kInlineCapacity - 1);
 
   va_list copy;
   va_copy(copy, args);
-  int needed = std::vsnprintf(buf, sizeof(buf), fmt, copy);
+  int needed = std::vsnprintf(buf, MessageText::kInlineCapacity, fmt, copy);
   va_end(copy);
 
   if (needed < 0) {
-    return "log formatting error";
+    out.assign("log formatting error");
+    return;
   }
-  if (needed < static_cast<int>(sizeof(buf))) {
-    return std::string(buf, static_cast<std::size_t>(needed));
+  const auto n = static_cast<std::size_t>(needed);
+  if (n < MessageText::kInlineCapacity) {
+    out.truncate(n);
+    return;
   }
 
-  std::vector<char> dyn(static_cast<std::size_t>(needed) + 1);
-  std::vsnprintf(dyn.data(), dyn.size(), fmt, args);
-  return std::string(dyn.data(), static_cast<std::size_t>(needed));
+  char* dyn = out.resize_for_write(n);
+  std::vsnprintf(dyn, n + 1, fmt, args);
+}
+
+// pass: the message passed should_log(); otherwise it is only recorded.
+static void log_vprintf(Logger& logger, LogLevel level, ModuleId id, bool pass,
+                        const char* fmt, va_list args) {
+  LogMessage msg{level, id};
+  vformat(msg.text, fmt, args);
+  if (pass) {
+    logger.submit(std::move(msg));
+  } else {
+    logger.record(msg);
+  }
 }
 
 void log_printf(Logger& logger,
@@ -34,13 +48,29 @@ void log_printf(Logger& logger,
                 const std::string& module,
                 const char* fmt,
                 ...) {
+  // Check levels before paying for vsnprintf.
+  const ModuleId id = ModuleRegistry::instance().intern(module);
+  const bool pass = logger.should_log(level, id);
+  if (!pass && !logger.recording(level)) return;
+
   va_list args;
   va_start(args, fmt);
-  std::string text = vformat(fmt, args);
+  log_vprintf(logger, level, id, pass, fmt, args);
   va_end(args);
+}
 
-  LogMessage msg{level, module, std::move(text)};
-  logger.log(std::move(msg));
+void log_printf(Logger& logger,
+                LogLevel level,
+                ModuleHandle module,
+                const char* fmt,
+                ...) {
+  const bool pass = logger.should_log(level, module);
+  if (!pass && !logger.recording(level)) return;
+
+  va_list args;
+  va_start(args, fmt);
+  log_vprintf(logger, level, module.id(), pass, fmt, args);
+  va_end(args);
 }
 
 }  // namespace rover_logger
@@ -0,0 +1,189 @@
+#include "rover_logger/binary_format.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace rover_logger {
+
+namespace {
+
+// Bodies are read in steps of this much, so a corrupt length allocates no
+// more than the input actually holds.
+constexpr std::size_t kReadChunk = 64u << 10;
+
+void put_varint(std::string& out, std::uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+    v >>= 7;
+  }
+  out.push_back(static_cast<char>(v));
+}
+
+std::uint64_t zigzag(std::int64_t v) {
+  return (static_cast<std::uint64_t>(v) << 1) ^
+         static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t v) {
+  return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+// Reads a varint from [p, end); false if truncated or over-long.
+bool get_varint(const char*& p, const char* end, std::uint64_t& v) {
+  v = 0;
+  for (int shift = 0; shift < 64 && p < end; shift += 7) {
+    const auto b = static_cast<unsigned char>(*p++);
+    v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+    if ((b & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+bool read_varint(std::istream& in, std::uint64_t& v, bool& eof_at_start) {
+  v = 0;
+  eof_at_start = false;
+  for (int shift = 0; shift < 64; shift += 7) {
+    const int c = in.get();
+    if (c == std::char_traits<char>::eof()) {
+      eof_at_start = (shift == 0);
+      return false;
+    }
+    v |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+    if ((c & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+void put_record(std::string& out, const std::string& body) {
+  put_varint(out, body.size());
+  out.append(body);
+}
+
+}  // namespace
+
+void BinaryLogEncoder::begin_file(std::string& out) {
+  body_.clear();
+  body_.push_back(static_cast<char>(binary_format::kHeaderRecord));
+  body_.append(binary_format::kMagic, sizeof(binary_format::kMagic));
+  body_.push_back(static_cast<char>(binary_format::kVersion));
+  body_.push_back('\0');  // flags
+  put_record(out, body_);
+  last_ts_ns_ = 0;
+  modules_written_.assign(modules_written_.size(), false);
+}
+
+void BinaryLogEncoder::append(std::string& out, const LogMessage& msg) {
+  const ModuleId id = msg.module.id() < modules_written_.size()
+                          ? msg.module.id()
+                          : ModuleRegistry::kUnknown;
+  if (!modules_written_[id]) {
+    body_.clear();
+    body_.push_back(static_cast<char>(binary_format::kModuleRecord));
+    put_varint(body_, id);
+    body_.append(msg.module.view());
+    put_record(out, body_);
+    modules_written_[id] = true;
+  }
+
+  using namespace std::chrono;
+  const std::int64_t ts =
+      duration_cast<nanoseconds>(msg.ts.time_since_epoch()).count();
+  body_.clear();
+  body_.push_back(static_cast<char>(binary_format::kLogRecord));
+  put_varint(body_, zigzag(ts - last_ts_ns_));
+  body_.push_back(static_cast<char>(msg.level));
+  put_varint(body_, id);
+  const std::string_view text = msg.text.view();
+  body_.append(text.substr(
+      0, std::min(text.size(), binary_format::kMaxRecordBytes - body_.size())));
+  put_record(out, body_);
+  last_ts_ns_ = ts;
+}
+
+bool BinaryLogDecoder::read_header(const char* p, const char* end) {
+  if (end - p < 5 ||
+      std::memcmp(p, binary_format::kMagic, sizeof(binary_format::kMagic)) != 0) {
+    error_ = "not a rover binary log (bad header)";
+    return false;
+  }
+  const auto version = static_cast<std::uint8_t>(p[4]);
+  if (version != binary_format::kVersion) {
+    error_ = "unsupported binary log version " + std::to_string(version);
+    return false;
+  }
+  in_file_ = true;
+  last_ts_ns_ = 0;
+  modules_.clear();
+  return true;
+}
+
+BinaryLogDecoder::Status BinaryLogDecoder::next(DecodedRecord& out) {
+  for (;;) {
+    std::uint64_t len = 0;
+    bool eof = false;
+    if (!read_varint(in_, len, eof)) {
+      if (eof) return Status::End;
+      error_ = "truncated record length";
+      return Status::Corrupt;
+    }
+    if (len == 0 || len > binary_format::kMaxRecordBytes) {
+      error_ = "bad record length " + std::to_string(len);
+      return Status::Corrupt;
+    }
+    body_.clear();
+    while (body_.size() < len) {
+      const std::size_t have = body_.size();
+      const std::size_t want = std::min<std::size_t>(len - have, kReadChunk);
+      body_.resize(have + want);
+      in_.read(body_.data() + have, static_cast<std::streamsize>(want));
+      if (static_cast<std::size_t>(in_.gcount()) != want) {
+        error_ = "truncated record";
+        return Status::Corrupt;
+      }
+    }
+
+    const char* p = body_.data() + 1;
+    const char* end = body_.data() + body_.size();
+    const auto type = static_cast<std::uint8_t>(body_[0]);
+    std::uint64_t v = 0;
+
+    if (type == binary_format::kHeaderRecord) {
+      if (!read_header(p, end)) return Status::Corrupt;
+      continue;
+    }
+    if (!in_file_) {
+      error_ = "not a rover binary log (missing header)";
+      return Status::Corrupt;
+    }
+    if (type == binary_format::kModuleRecord) {
+      if (!get_varint(p, end, v)) {
+        error_ = "bad module record";
+        return Status::Corrupt;
+      }
+      modules_[v].assign(p, end);
+      continue;
+    }
+    if (type != binary_format::kLogRecord) continue;  // newer record type
+
+    if (!get_varint(p, end, v) || p >= end) {
+      error_ = "bad log record";
+      return Status::Corrupt;
+    }
+    last_ts_ns_ += unzigzag(v);
+    const auto level = static_cast<std::uint8_t>(*p++);
+    if (!get_varint(p, end, v) ||
+        level > static_cast<std::uint8_t>(LogLevel::FATAL)) {
+      error_ = "bad log record";
+      return Status::Corrupt;
+    }
+    auto it = modules_.find(v);
+    out.ts_ns = last_ts_ns_;
+    out.level = static_cast<LogLevel>(level);
+    out.module = it != modules_.end() ? std::string_view(it->second) : "?";
+    out.text = std::string_view(p, static_cast<std::size_t>(end - p));
+    return Status::Record;
+  }
+}
+
+}  // namespace rover_logger
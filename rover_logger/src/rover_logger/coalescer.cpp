@@ -0,0 +1,134 @@
+#include "rover_logger/coalescer.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "rover_logger/json_formatter.hpp"
+
+namespace rover_logger {
+
+Coalescer::Coalescer(std::chrono::milliseconds window, std::size_t max_entries)
+    : window_(window),
+      max_entries_(std::max<std::size_t>(max_entries, 1)),
+      entries_(max_entries_) {
+  std::size_t cap = 2;
+  while (cap < 2 * max_entries_) cap <<= 1;
+  cells_.resize(cap);
+  mask_ = cap - 1;
+  repeating_.reserve(max_entries_);
+}
+
+std::uint64_t Coalescer::key(const LogMessage& msg) {
+  const std::uint64_t h = std::hash<std::string_view>{}(msg.text.view());
+  return h ^ ((std::uint64_t{msg.module.id()} << 8 |
+               static_cast<std::uint64_t>(msg.level)) *
+              0x9E3779B97F4A7C15ull);
+}
+
+std::size_t Coalescer::find(std::uint64_t hash) const {
+  std::size_t i = hash & mask_;
+  while (cells_[i].seq != kEmpty && cells_[i].hash != hash) i = (i + 1) & mask_;
+  return i;
+}
+
+// Backward-shift deletion: pulls later cells of the probe run into the gap
+// so lookups never need tombstones.
+void Coalescer::erase_cell(std::size_t i) {
+  for (std::size_t j = (i + 1) & mask_; cells_[j].seq != kEmpty;
+       j = (j + 1) & mask_) {
+    const std::size_t home = cells_[j].hash & mask_;
+    if (((j - home) & mask_) >= ((j - i) & mask_)) {
+      cells_[i] = cells_[j];
+      i = j;
+    }
+  }
+  cells_[i].seq = kEmpty;
+}
+
+void Coalescer::process(const LogMessage* msgs, std::size_t count,
+                        std::vector<LogMessage>& out) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const LogMessage& msg = msgs[i];
+    expire(msg.ts, out);
+
+    const std::uint64_t h = key(msg);
+    std::size_t c = find(h);
+    if (cells_[c].seq != kEmpty) {
+      Entry& e = entry(cells_[c].seq);
+      // The first repeat is matched on the hash; later ones on the text
+      // it copied. On a hash collision the message is not tracked.
+      if (e.module == msg.module.id() && e.level == msg.level &&
+          (e.repeats == 0 || e.text == msg.text.view())) {
+        if (e.repeats == 0) {
+          e.text = msg.text;
+          repeating_.push_back(cells_[c].seq);
+          std::push_heap(repeating_.begin(), repeating_.end(),
+                         std::greater<>());
+        }
+        ++e.repeats;
+        e.last_ts = msg.ts;
+        coalesced_.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      out.push_back(msg);
+      continue;
+    }
+
+    if (size_ == max_entries_) {
+      close_oldest(out);
+      c = find(h);  // the erase may have shifted cells
+    }
+    const std::uint64_t seq = head_ + size_++;
+    Entry& e = entry(seq);
+    e.hash = h;
+    e.first_ts = msg.ts;
+    e.last_ts = msg.ts;
+    e.repeats = 0;
+    e.module = msg.module.id();
+    e.level = msg.level;
+    cells_[c] = Cell{h, seq};
+    out.push_back(msg);
+  }
+}
+
+void Coalescer::expire(clock::time_point now, std::vector<LogMessage>& out) {
+  while (size_ > 0 && now - entry(head_).first_ts >= window_) {
+    close_oldest(out);
+  }
+}
+
+void Coalescer::expire_all(std::vector<LogMessage>& out) {
+  while (size_ > 0) close_oldest(out);
+}
+
+std::optional<Coalescer::clock::time_point> Coalescer::next_due() const {
+  if (repeating_.empty()) return std::nullopt;
+  return entry(repeating_.front()).first_ts + window_;
+}
+
+void Coalescer::close_oldest(std::vector<LogMessage>& out) {
+  const Entry& e = entry(head_);
+  if (e.repeats > 0) {
+    // Oldest first: a repeating head is also the top of the heap.
+    std::pop_heap(repeating_.begin(), repeating_.end(), std::greater<>());
+    repeating_.pop_back();
+
+    std::string text(e.text.view());
+    text += " [repeated ";
+    text += std::to_string(e.repeats);
+    text += " times, first ";
+    text += iso8601_utc_ms(e.first_ts);
+    text += ", last ";
+    text += iso8601_utc_ms(e.last_ts);
+    text += ']';
+    LogMessage& sum = out.emplace_back(e.level, e.module, text);
+    sum.ts = e.last_ts;
+  }
+  erase_cell(find(e.hash));
+  ++head_;
+  --size_;
+}
+
+}  // namespace rover_logger
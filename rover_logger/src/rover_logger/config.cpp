@@ -43,6 +43,79 @@ LogLevel parse_level(std::string_view s) {
   throw std::invalid_argument(oss.str());
 }
 
+// -----------------------------------------------------------------------------
+// parse_queue_mode
+// -----------------------------------------------------------------------------
+// Convert "shared" / "per_thread" into a QueueMode (case-insensitive).
+// Throws std::invalid_argument for unknown strings.
+// -----------------------------------------------------------------------------
+QueueMode parse_queue_mode(std::string_view s) {
+  const std::string k = to_lower(s);
+  if (k == "shared") return QueueMode::Shared;
+  if (k == "per_thread" || k == "per-thread") return QueueMode::PerThread;
+
+  std::ostringstream oss;
+  oss << "Unknown queue mode: \"" << s << "\"";
+  throw std::invalid_argument(oss.str());
+}
+
+// -----------------------------------------------------------------------------
+// parse_overflow_policy
+// -----------------------------------------------------------------------------
+// Convert "drop_oldest", "drop_newest", "block" or "level_aware" into an
+// OverflowPolicy (case-insensitive, '-' accepted for '_').
+// -----------------------------------------------------------------------------
+OverflowPolicy parse_overflow_policy(std::string_view s) {
+  std::string k = to_lower(s);
+  for (char& c : k) {
+    if (c == '-') c = '_';
+  }
+  if (k == "drop_oldest") return OverflowPolicy::DropOldest;
+  if (k == "drop_newest") return OverflowPolicy::DropNewest;
+  if (k == "block") return OverflowPolicy::Block;
+  if (k == "level_aware") return OverflowPolicy::LevelAware;
+
+  std::ostringstream oss;
+  oss << "Unknown overflow policy: \"" << s << "\"";
+  throw std::invalid_argument(oss.str());
+}
+
+// -----------------------------------------------------------------------------
+// parse_dispatch_mode
+// -----------------------------------------------------------------------------
+// Convert "inline" / "per_sink" into a DispatchMode (case-insensitive).
+// Throws std::invalid_argument for unknown strings.
+// -----------------------------------------------------------------------------
+DispatchMode parse_dispatch_mode(std::string_view s) {
+  const std::string k = to_lower(s);
+  if (k == "inline") return DispatchMode::Inline;
+  if (k == "per_sink" || k == "per-sink") return DispatchMode::PerSink;
+
+  std::ostringstream oss;
+  oss << "Unknown dispatch mode: \"" << s << "\"";
+  throw std::invalid_argument(oss.str());
+}
+
+// -----------------------------------------------------------------------------
+// parse_timestamp_format
+// -----------------------------------------------------------------------------
+// Convert "iso8601_ms", "epoch_ns", ... into a TimestampFormat
+// (case-insensitive). Throws std::invalid_argument for unknown strings.
+// -----------------------------------------------------------------------------
+TimestampFormat parse_timestamp_format(std::string_view s) {
+  const std::string k = to_lower(s);
+  if (k == "iso8601_ms" || k == "iso8601") return TimestampFormat::Iso8601Millis;
+  if (k == "iso8601_us") return TimestampFormat::Iso8601Micros;
+  if (k == "iso8601_ns") return TimestampFormat::Iso8601Nanos;
+  if (k == "epoch_ms") return TimestampFormat::EpochMillis;
+  if (k == "epoch_us") return TimestampFormat::EpochMicros;
+  if (k == "epoch_ns") return TimestampFormat::EpochNanos;
+
+  std::ostringstream oss;
+  oss << "Unknown timestamp format: \"" << s << "\"";
+  throw std::invalid_argument(oss.str());
+}
+
 // -----------------------------------------------------------------------------
 // Optional getters
 // -----------------------------------------------------------------------------
@@ -67,6 +140,12 @@ static std::optional<std::size_t> get_opt_size(const YAML::Node& n,
   return std::nullopt;
 }
 
+static std::optional<LogLevel> get_opt_level(const YAML::Node& n,
+                                             const char* key) {
+  if (n[key]) return parse_level(n[key].as<std::string>());
+  return std::nullopt;
+}
+
 static std::optional<std::string> get_opt_str(const YAML::Node& n,
                                               const char* key) {
   if (n[key]) return n[key].as<std::string>();
@@ -87,7 +166,15 @@ static std::optional<std::string> get_opt_str(const YAML::Node& n,
 //   - type: file
 //     path: "rover_log"
 //     rotation_bytes: 524288000
+//     rotate_keep: 10
 //     compress: true
+//     compress_level: 6
+//     format: json
+//     timestamp: iso8601_ms
+//     flush_level: warn
+//     sync_level: error
+//     coalesce_window_ms: 1000   # any sink type
+//     coalesce_entries: 64
 //
 // Only "type" is required. Everything else is optional and depends on sink type.
 // -----------------------------------------------------------------------------
@@ -108,12 +195,79 @@ static SinkConfig parse_sink(const YAML::Node& n) {
   sc.rotation_bytes = get_opt_size(n, "rotation_bytes");
   sc.rotate_keep    = get_opt_int(n,  "rotate_keep");
   sc.compress       = get_opt_bool(n, "compress");
+  sc.compress_level = get_opt_int(n,  "compress_level");
+  sc.compress_nice  = get_opt_int(n,  "compress_nice");
+  sc.format         = get_opt_str(n,  "format");
+  sc.timestamp      = get_opt_str(n,  "timestamp");
+  sc.flush_level    = get_opt_level(n, "flush_level");
+  sc.sync_level     = get_opt_level(n, "sync_level");
+  sc.coalesce_window_ms = get_opt_size(n, "coalesce_window_ms");
+  sc.coalesce_entries   = get_opt_size(n, "coalesce_entries");
+
+  // Reject bad values at load time rather than in make_sink.
+  if (sc.timestamp) (void)parse_timestamp_format(*sc.timestamp);
+  if (sc.format && *sc.format != "json" && *sc.format != "text" &&
+      *sc.format != "binary")
+    throw std::runtime_error("Unknown file format: \"" + *sc.format + "\"");
+  if (sc.rotate_keep && *sc.rotate_keep < 0)
+    throw std::runtime_error("rotate_keep must not be negative");
+  if (sc.compress_level && (*sc.compress_level < 1 || *sc.compress_level > 9))
+    throw std::runtime_error("compress_level must be between 1 and 9");
+  if (sc.coalesce_entries && *sc.coalesce_entries == 0)
+    throw std::runtime_error("coalesce_entries must be positive");
   sc.host           = get_opt_str(n,  "host");
   sc.port           = get_opt_int(n,  "port");
 
   return sc;
 }
 
+// -----------------------------------------------------------------------------
+// parse_module
+// -----------------------------------------------------------------------------
+// Parse one entry of the modules map. A plain level is the short form:
+//
+// modules:
+//   /drive: error
+//   /vision:
+//     level: info
+//     rate_limit: 50      # messages per second
+//     burst: 100          # default: rate_limit
+//     sample: 10          # keep 1 in 10 per call site
+//
+// Every key of the long form is optional.
+// -----------------------------------------------------------------------------
+static void parse_module(const std::string& name, const YAML::Node& n,
+                         LoggerConfig& cfg) {
+  if (n.IsScalar()) {
+    cfg.modules.emplace(name, parse_level(n.as<std::string>()));
+    return;
+  }
+  if (!n.IsMap())
+    throw std::runtime_error("module \"" + name + "\" must be a level or a map");
+
+  if (auto lv = get_opt_level(n, "level")) cfg.modules.emplace(name, *lv);
+
+  ModuleLimit lim;
+  if (n["rate_limit"]) {
+    lim.rate = n["rate_limit"].as<double>();
+    if (lim.rate < 0)
+      throw std::runtime_error("rate_limit must not be negative");
+  }
+  if (n["burst"]) {
+    const auto val = n["burst"].as<long long>();
+    if (val < 0)
+      throw std::runtime_error("burst must not be negative");
+    lim.burst = static_cast<std::size_t>(val);
+  }
+  if (n["sample"]) {
+    const auto val = n["sample"].as<long long>();
+    if (val <= 0)
+      throw std::runtime_error("sample must be positive");
+    lim.sample = static_cast<std::size_t>(val);
+  }
+  if (lim.active()) cfg.module_limits.emplace(name, lim);
+}
+
 // -----------------------------------------------------------------------------
 // load_config_file
 // -----------------------------------------------------------------------------
@@ -123,7 +277,8 @@ static SinkConfig parse_sink(const YAML::Node& n) {
 //  - file must load
 //  - top-level YAML must be a map
 //  - "sinks" must be a sequence
-//  - "modules" must be a mapping of name → level
+//  - "modules" must be a mapping of name → level, or name → map with
+//    level / rate_limit / burst / sample (see parse_module)
 //
 // Returns a fully-populated LoggerConfig object.
 // -----------------------------------------------------------------------------
@@ -159,6 +314,88 @@ LoggerConfig load_config_file(const std::string& path) {
     cfg.max_queue = static_cast<std::size_t>(val);
   }
 
+  // Producer queue layout
+  if (root["queue_mode"]) {
+    cfg.queue_mode = parse_queue_mode(root["queue_mode"].as<std::string>());
+  }
+
+  // Full-queue behaviour
+  if (root["overflow"]) {
+    cfg.overflow = parse_overflow_policy(root["overflow"].as<std::string>());
+  }
+  if (root["block_timeout_ms"]) {
+    const auto val = root["block_timeout_ms"].as<long long>();
+    if (val < 0)
+      throw std::runtime_error("block_timeout_ms must not be negative");
+    cfg.block_timeout_ms = static_cast<std::size_t>(val);
+  }
+
+  // Sink fan-out
+  if (root["dispatch"]) {
+    cfg.dispatch = parse_dispatch_mode(root["dispatch"].as<std::string>());
+  }
+  if (root["sink_queue"]) {
+    const auto val = root["sink_queue"].as<long long>();
+    if (val < 0)
+      throw std::runtime_error("sink_queue must not be negative");
+    cfg.sink_queue = static_cast<std::size_t>(val);
+  }
+
+  // Worker batching
+  if (root["batch_max"]) {
+    const auto val = root["batch_max"].as<long long>();
+    if (val <= 0)
+      throw std::runtime_error("batch_max must be positive");
+    cfg.batch_max = static_cast<std::size_t>(val);
+  }
+  if (root["batch_linger_ms"]) {
+    const auto val = root["batch_linger_ms"].as<long long>();
+    if (val < 0)
+      throw std::runtime_error("batch_linger_ms must not be negative");
+    cfg.batch_linger_ms = static_cast<std::size_t>(val);
+  }
+
+  if (root["flush_interval_ms"]) {
+    const auto val = root["flush_interval_ms"].as<long long>();
+    if (val < 0)
+      throw std::runtime_error("flush_interval_ms must not be negative");
+    cfg.flush_interval_ms = static_cast<std::size_t>(val);
+  }
+
+  // Synchronous, durable writes for the most severe messages
+  if (root["emergency_level"]) {
+    cfg.emergency_level = parse_level(root["emergency_level"].as<std::string>());
+  }
+
+  // Metrics publishing (ROS bridge)
+  if (root["metrics_interval_ms"]) {
+    const auto val = root["metrics_interval_ms"].as<long long>();
+    if (val < 0)
+      throw std::runtime_error("metrics_interval_ms must not be negative");
+    cfg.metrics_interval_ms = static_cast<std::size_t>(val);
+  }
+
+  // Crash flight recorder
+  if (root["flight_recorder"]) {
+    const YAML::Node& fr = root["flight_recorder"];
+    if (!fr.IsMap())
+      throw std::runtime_error("flight_recorder must be a map");
+    FlightRecorderConfig& rc = cfg.flight_recorder;
+    rc.enabled = get_opt_bool(fr, "enabled").value_or(true);
+    rc.level = get_opt_level(fr, "level").value_or(rc.level);
+    if (fr["records_per_thread"]) {
+      const auto val = fr["records_per_thread"].as<long long>();
+      if (val <= 0)
+        throw std::runtime_error("flight_recorder.records_per_thread must be positive");
+      rc.records_per_thread = static_cast<std::size_t>(val);
+    }
+    rc.path = get_opt_str(fr, "path").value_or(rc.path);
+    if (rc.path.empty())
+      throw std::runtime_error("flight_recorder.path must not be empty");
+    rc.on_signal = get_opt_bool(fr, "on_signal").value_or(rc.on_signal);
+    rc.dump_on_exit = get_opt_bool(fr, "dump_on_exit").value_or(rc.dump_on_exit);
+  }
+
   // Parse sinks array
   if (root["sinks"]) {
     const YAML::Node& arr = root["sinks"];
@@ -171,16 +408,14 @@ LoggerConfig load_config_file(const std::string& path) {
     }
   }
 
-  // Parse per-module log levels
+  // Parse per-module log levels and limits
   if (root["modules"]) {
     const YAML::Node& mods = root["modules"];
     if (!mods.IsMap())
       throw std::runtime_error("modules must be a map of name->level");
 
     for (const auto& kv : mods) {
-      const std::string name = kv.first.as<std::string>();
-      const std::string lvl  = kv.second.as<std::string>();
-      cfg.modules.emplace(name, parse_level(lvl));
+      parse_module(kv.first.as<std::string>(), kv.second, cfg);
     }
   }
 
@@ -0,0 +1,221 @@
+#include "rover_logger/deferred_format.hpp"
+
+#include <cstdio>
+
+namespace rover_logger {
+
+namespace {
+
+using deferred_detail::Arg;
+using deferred_detail::ArgReader;
+using deferred_detail::ArgTag;
+
+long long as_signed(const Arg& a) {
+  switch (a.tag) {
+    case ArgTag::Int:
+      return a.i;
+    case ArgTag::UInt:
+    case ArgTag::Pointer:
+      return static_cast<long long>(a.u);
+    case ArgTag::Double:
+      return static_cast<long long>(a.d);
+    case ArgTag::LongDouble:
+      return static_cast<long long>(a.ld);
+    case ArgTag::String:
+      return 0;
+  }
+  return 0;
+}
+
+long double as_long_double(const Arg& a) {
+  switch (a.tag) {
+    case ArgTag::Double:
+      return a.d;
+    case ArgTag::LongDouble:
+      return a.ld;
+    case ArgTag::UInt:
+    case ArgTag::Pointer:
+      return static_cast<long double>(a.u);
+    default:
+      return static_cast<long double>(as_signed(a));
+  }
+}
+
+template <class V>
+void append_formatted(std::string& out, const char* spec, V v) {
+  char buf[128];
+  const int n = std::snprintf(buf, sizeof(buf), spec, v);
+  if (n < 0) return;
+  const auto len = static_cast<std::size_t>(n);
+  if (len < sizeof(buf)) {
+    out.append(buf, len);
+    return;
+  }
+  const std::size_t old = out.size();
+  out.resize(old + len + 1);
+  std::snprintf(&out[old], len + 1, spec, v);
+  out.resize(old + len);
+}
+
+// Applies the integer length modifier the caller wrote (%hhd, %ld, ...)
+// so truncation matches what printf would have printed.
+long long narrow_signed(long long v, std::string_view len) {
+  if (len == "hh") return static_cast<signed char>(v);
+  if (len == "h") return static_cast<short>(v);
+  if (len.empty()) return static_cast<int>(v);
+  if (len == "l") return static_cast<long>(v);
+  return v;
+}
+
+unsigned long long narrow_unsigned(unsigned long long v, std::string_view len) {
+  if (len == "hh") return static_cast<unsigned char>(v);
+  if (len == "h") return static_cast<unsigned short>(v);
+  if (len.empty()) return static_cast<unsigned int>(v);
+  if (len == "l") return static_cast<unsigned long>(v);
+  return v;
+}
+
+}  // namespace
+
+void format_deferred(LogMessage& msg, std::string& scratch) {
+  if (msg.fmt == nullptr) return;
+
+  scratch.clear();
+  ArgReader args(msg.text.data(), msg.text.size());
+  Arg a;
+  const char* f = msg.fmt;
+
+  while (*f != '\0') {
+    const char* pct = std::strchr(f, '%');
+    if (pct == nullptr) {
+      scratch.append(f);
+      break;
+    }
+    scratch.append(f, static_cast<std::size_t>(pct - f));
+    f = pct + 1;
+    if (*f == '%') {
+      scratch.push_back('%');
+      ++f;
+      continue;
+    }
+
+    // Rebuild the conversion spec: %[flags][width][.precision]<conv>, with
+    // '*' resolved from the argument list and the length modifier
+    // normalised to what we pass to snprintf.
+    char spec[64];
+    std::size_t sn = 0;
+    auto emit = [&](char c) {
+      if (sn + 1 < sizeof(spec)) spec[sn++] = c;
+    };
+    // Appends the normalised length modifier and conversion, terminates.
+    auto finish = [&](const char* length, char c) {
+      for (; *length != '\0'; ++length) emit(*length);
+      emit(c);
+      spec[sn] = '\0';
+    };
+    auto emit_int = [&](long long v) {
+      char num[24];
+      const int k = std::snprintf(num, sizeof(num), "%lld", v);
+      for (int j = 0; j < k; ++j) emit(num[j]);
+    };
+
+    emit('%');
+    while (*f != '\0' && std::strchr("-+ #0'", *f) != nullptr) emit(*f++);
+    if (*f == '*') {
+      ++f;
+      emit_int(args.next(a) ? as_signed(a) : 0);
+    } else {
+      while (*f >= '0' && *f <= '9') emit(*f++);
+    }
+    if (*f == '.') {
+      emit(*f++);
+      if (*f == '*') {
+        ++f;
+        emit_int(args.next(a) ? as_signed(a) : 0);
+      } else {
+        while (*f >= '0' && *f <= '9') emit(*f++);
+      }
+    }
+    const char* len_begin = f;
+    while (*f != '\0' && std::strchr("hlLqjzt", *f) != nullptr) ++f;
+    const std::string_view len(len_begin,
+                               static_cast<std::size_t>(f - len_begin));
+    const char conv = *f;
+    if (conv == '\0') break;
+    ++f;
+
+    if (!args.next(a)) {
+      scratch.append("<missing>");
+      continue;
+    }
+    if (a.tag == ArgTag::String && conv != 's') {
+      // Strings are captured by value, so any conversion prints the text.
+      scratch.append(a.s);
+      continue;
+    }
+
+    switch (conv) {
+      case 'd':
+      case 'i':
+        finish("ll", conv);
+        append_formatted(scratch, spec, narrow_signed(as_signed(a), len));
+        break;
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        finish("ll", conv);
+        append_formatted(
+            scratch, spec,
+            narrow_unsigned(static_cast<unsigned long long>(as_signed(a)),
+                            len));
+        break;
+      case 'c':
+        finish("", conv);
+        append_formatted(scratch, spec, static_cast<int>(as_signed(a)));
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        if (a.tag == ArgTag::LongDouble) {
+          finish("L", conv);
+          append_formatted(scratch, spec, a.ld);
+        } else {
+          finish("", conv);
+          append_formatted(scratch, spec,
+                           static_cast<double>(as_long_double(a)));
+        }
+        break;
+      case 's':
+        if (a.tag == ArgTag::String) {
+          finish("", 's');
+          append_formatted(scratch, spec, a.s);
+        } else {
+          // Numeric value for %s: print it rather than crash.
+          append_formatted(scratch, "%lld", as_signed(a));
+        }
+        break;
+      case 'p':
+        finish("", 'p');
+        append_formatted(scratch, spec,
+                         reinterpret_cast<const void*>(
+                             static_cast<std::uintptr_t>(a.u)));
+        break;
+      default:
+        // Unsupported conversion (%n, %ls, ...): keep the spec text.
+        scratch.push_back('%');
+        scratch.append(len_begin, static_cast<std::size_t>(f - len_begin));
+        break;
+    }
+  }
+
+  msg.text.assign(scratch);
+  msg.fmt = nullptr;
+}
+
+}  // namespace rover_logger
@@ -0,0 +1,600 @@
+#include "rover_logger/flight_recorder.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "rover_logger/deferred_format.hpp"
+
+namespace rover_logger {
+
+// Written only by the ring's thread. seq is 2 * (writes to this slot so
+// far) and odd while a write is in progress, so a reader can tell which
+// record a slot holds and whether it changed under it.
+struct FlightRecorder::Slot {
+  std::atomic<std::uint32_t> seq{0};
+  std::uint8_t level = 0;
+  std::uint8_t flags = 0;  // kDeferred, kTruncated
+  std::uint16_t len = 0;
+  ModuleId module = 0;
+  std::int64_t ts_ns = 0;
+  const char* fmt = nullptr;
+  char data[kSlotBytes - 32];
+
+  static constexpr std::uint8_t kDeferred = 1;
+  static constexpr std::uint8_t kTruncated = 2;
+};
+
+struct FlightRecorder::Ring {
+  explicit Ring(std::size_t cap) : slots(new Slot[cap]) {}
+
+  std::unique_ptr<Slot[]> slots;
+  std::atomic<std::uint64_t> head{0};  // records ever written
+  std::atomic<bool> owned{true};       // a live thread writes here
+};
+
+namespace {
+
+std::atomic<std::uint64_t> g_next_recorder_id{1};
+
+// Live recorders, for the crash handler (which can take no locks).
+constexpr std::size_t kMaxRecorders = 8;
+std::atomic<const FlightRecorder*> g_recorders[kMaxRecorders];
+
+constexpr int kCrashSignals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+constexpr std::size_t kNumCrashSignals =
+    sizeof(kCrashSignals) / sizeof(kCrashSignals[0]);
+struct sigaction g_previous[kNumCrashSignals];
+std::atomic<bool> g_installed{false};
+std::atomic<bool> g_crashing{false};
+
+// An alternate signal stack for the calling thread, so the crash handler
+// can still run after a stack overflow. sigaltstack is per thread; a
+// stack the thread already has (e.g. from a sanitizer) is left alone.
+// Removed again when the thread exits.
+class AltStack {
+ public:
+  AltStack() {
+    stack_t cur{};
+    if (::sigaltstack(nullptr, &cur) == 0 && (cur.ss_flags & SS_DISABLE) == 0) {
+      return;
+    }
+    const std::size_t size =
+        std::max<std::size_t>(64 * 1024, static_cast<std::size_t>(SIGSTKSZ));
+    mem_ = std::make_unique<char[]>(size);
+    stack_t ss{};
+    ss.ss_sp = mem_.get();
+    ss.ss_size = size;
+    if (::sigaltstack(&ss, nullptr) != 0) mem_.reset();
+  }
+  ~AltStack() {
+    if (!mem_) return;
+    stack_t ss{};
+    ss.ss_flags = SS_DISABLE;
+    ::sigaltstack(&ss, nullptr);
+  }
+
+  AltStack(const AltStack&) = delete;
+  AltStack& operator=(const AltStack&) = delete;
+
+ private:
+  std::unique_ptr<char[]> mem_;
+};
+
+void ensure_alt_stack() { thread_local AltStack stack; }
+
+const char* signal_name(int sig) {
+  switch (sig) {
+    case SIGSEGV:
+      return "SIGSEGV";
+    case SIGBUS:
+      return "SIGBUS";
+    case SIGFPE:
+      return "SIGFPE";
+    case SIGILL:
+      return "SIGILL";
+    case SIGABRT:
+      return "SIGABRT";
+  }
+  return "signal";
+}
+
+// Buffered writer for the dump: write(2) only, no allocation.
+class DumpWriter {
+ public:
+  explicit DumpWriter(int fd) : fd_(fd) {}
+
+  void put(char c) {
+    if (used_ == sizeof(buf_)) flush();
+    buf_[used_++] = c;
+  }
+  void put(const char* s, std::size_t n) {
+    while (n > 0) {
+      if (used_ == sizeof(buf_)) flush();
+      const std::size_t k = std::min(n, sizeof(buf_) - used_);
+      std::memcpy(buf_ + used_, s, k);
+      used_ += k;
+      s += k;
+      n -= k;
+    }
+  }
+  void put(const char* s) { put(s, std::strlen(s)); }
+  void put(std::string_view s) { put(s.data(), s.size()); }
+
+  void put_uint(std::uint64_t v, unsigned base = 10, int min_digits = 1) {
+    char tmp[24];
+    int n = 0;
+    do {
+      tmp[n++] = "0123456789abcdef"[v % base];
+      v /= base;
+    } while (v != 0);
+    for (; n < min_digits; ++n) tmp[n] = '0';
+    while (n > 0) put(tmp[--n]);
+  }
+
+  void put_int(std::int64_t v) {
+    if (v < 0) {
+      put('-');
+      put_uint(0 - static_cast<std::uint64_t>(v));
+    } else {
+      put_uint(static_cast<std::uint64_t>(v));
+    }
+  }
+
+  // Fixed notation (exponent form for huge values); enough for a crash
+  // log, and snprintf is not async-signal-safe.
+  void put_double(double v, int precision) {
+    if (std::isnan(v)) return put("nan");
+    if (v < 0) {
+      put('-');
+      v = -v;
+    }
+    if (std::isinf(v)) return put("inf");
+    precision = std::clamp(precision, 0, 9);
+    int exp10 = 0;
+    if (v >= 1e18) {
+      while (v >= 10.0) {
+        v /= 10.0;
+        ++exp10;
+      }
+    }
+    std::uint64_t scale = 1;
+    for (int i = 0; i < precision; ++i) scale *= 10;
+    auto ip = static_cast<std::uint64_t>(v);
+    auto frac = static_cast<std::uint64_t>((v - static_cast<double>(ip)) *
+                                               static_cast<double>(scale) +
+                                           0.5);
+    if (frac >= scale) {
+      ++ip;
+      frac -= scale;
+    }
+    put_uint(ip);
+    if (precision > 0) {
+      put('.');
+      put_uint(frac, 10, precision);
+    }
+    if (exp10 != 0) {
+      put("e+");
+      put_uint(static_cast<std::uint64_t>(exp10), 10, 2);
+    }
+  }
+
+  // 2025-01-01T12:00:00.123456789Z, from days-since-epoch arithmetic
+  // (gmtime_r is not async-signal-safe).
+  void put_timestamp(std::int64_t ns) {
+    constexpr std::int64_t kNs = 1000000000;
+    std::int64_t secs = ns / kNs;
+    std::int64_t sub = ns % kNs;
+    if (sub < 0) {
+      sub += kNs;
+      --secs;
+    }
+    std::int64_t days = secs / 86400;
+    std::int64_t sod = secs % 86400;
+    if (sod < 0) {
+      sod += 86400;
+      --days;
+    }
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto doe = static_cast<std::uint64_t>(days - era * 146097);
+    const std::uint64_t yoe =
+        (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const std::uint64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const std::uint64_t mp = (5 * doy + 2) / 153;
+    const std::uint64_t day = doy - (153 * mp + 2) / 5 + 1;
+    const std::uint64_t month = mp < 10 ? mp + 3 : mp - 9;
+    const std::int64_t year =
+        static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+
+    put_int(year);
+    put('-');
+    put_uint(month, 10, 2);
+    put('-');
+    put_uint(day, 10, 2);
+    put('T');
+    put_uint(static_cast<std::uint64_t>(sod / 3600), 10, 2);
+    put(':');
+    put_uint(static_cast<std::uint64_t>(sod / 60 % 60), 10, 2);
+    put(':');
+    put_uint(static_cast<std::uint64_t>(sod % 60), 10, 2);
+    put('.');
+    put_uint(static_cast<std::uint64_t>(sub), 10, 9);
+    put('Z');
+  }
+
+  bool flush() {
+    std::size_t off = 0;
+    while (off < used_) {
+      const ssize_t n = ::write(fd_, buf_ + off, used_ - off);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        ok_ = false;
+        break;
+      }
+      off += static_cast<std::size_t>(n);
+    }
+    used_ = 0;
+    return ok_;
+  }
+
+  bool ok() const { return ok_; }
+
+ private:
+  int fd_;
+  char buf_[4096];
+  std::size_t used_ = 0;
+  bool ok_ = true;
+};
+
+// Renders a deferred record like format_deferred() does, minus snprintf:
+// widths and flags are ignored, floats are printed fixed-point. Arguments
+// cut off by the slot size print as "<missing>".
+void put_deferred(DumpWriter& out, const char* fmt, const char* data,
+                  std::size_t len) {
+  using deferred_detail::ArgTag;
+  deferred_detail::ArgReader args(data, len);
+  deferred_detail::Arg a;
+
+  auto as_int = [&]() -> std::int64_t {
+    if (!args.next(a)) return 0;
+    return a.tag == ArgTag::Int ? a.i : static_cast<std::int64_t>(a.u);
+  };
+
+  const char* f = fmt;
+  while (*f != '\0') {
+    if (*f != '%') {
+      out.put(*f++);
+      continue;
+    }
+    ++f;
+    if (*f == '%') {
+      out.put('%');
+      ++f;
+      continue;
+    }
+    while (*f != '\0' && std::strchr("-+ #0'", *f) != nullptr) ++f;
+    if (*f == '*') {
+      ++f;
+      (void)as_int();
+    } else {
+      while (*f >= '0' && *f <= '9') ++f;
+    }
+    int precision = -1;
+    if (*f == '.') {
+      ++f;
+      precision = 0;
+      if (*f == '*') {
+        ++f;
+        precision = static_cast<int>(as_int());
+      } else {
+        while (*f >= '0' && *f <= '9') precision = precision * 10 + (*f++ - '0');
+      }
+    }
+    while (*f != '\0' && std::strchr("hlLqjzt", *f) != nullptr) ++f;
+    const char conv = *f;
+    if (conv == '\0') break;
+    ++f;
+
+    if (!args.next(a)) {
+      out.put("<missing>");
+      continue;
+    }
+    const unsigned base = (conv == 'x' || conv == 'X') ? 16 : conv == 'o' ? 8 : 10;
+    switch (a.tag) {
+      case ArgTag::String: {
+        std::size_t n = std::strlen(a.s);
+        if (precision >= 0) n = std::min(n, static_cast<std::size_t>(precision));
+        out.put(a.s, n);
+        break;
+      }
+      case ArgTag::Int:
+        if (conv == 'c') {
+          out.put(static_cast<char>(a.i));
+        } else if (base != 10) {
+          out.put_uint(static_cast<std::uint64_t>(a.i), base);
+        } else {
+          out.put_int(a.i);
+        }
+        break;
+      case ArgTag::UInt:
+        if (conv == 'c') {
+          out.put(static_cast<char>(a.u));
+        } else {
+          out.put_uint(a.u, base);
+        }
+        break;
+      case ArgTag::Pointer:
+        out.put("0x");
+        out.put_uint(a.u, 16);
+        break;
+      case ArgTag::Double:
+        out.put_double(a.d, precision < 0 ? 6 : precision);
+        break;
+      case ArgTag::LongDouble:
+        out.put_double(static_cast<double>(a.ld), precision < 0 ? 6 : precision);
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+FlightRecorder::FlightRecorder(std::string path, std::size_t records_per_thread)
+    : path_(std::move(path)),
+      cap_(records_per_thread == 0 ? 1 : records_per_thread),
+      id_(g_next_recorder_id.fetch_add(1, std::memory_order_relaxed)) {
+  static_assert(sizeof(Slot) == kSlotBytes, "slots should stay 4 lines");
+  for (auto& r : rings_) r.store(nullptr, std::memory_order_relaxed);
+  for (auto& g : g_recorders) {
+    const FlightRecorder* expected = nullptr;
+    if (g.compare_exchange_strong(expected, this, std::memory_order_acq_rel)) {
+      break;
+    }
+  }
+}
+
+FlightRecorder::~FlightRecorder() {
+  for (auto& g : g_recorders) {
+    const FlightRecorder* expected = this;
+    g.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+  }
+}
+
+std::shared_ptr<FlightRecorder::Ring> FlightRecorder::claim_ring() {
+  std::scoped_lock lk(rings_mutex_);
+  // Prefer a ring whose thread exited: its records stay readable until
+  // the new owner overwrites them.
+  for (const auto& r : owned_) {
+    bool expected = false;
+    if (r->owned.compare_exchange_strong(expected, true,
+                                         std::memory_order_acq_rel)) {
+      return r;
+    }
+  }
+  if (owned_.size() >= kMaxThreads) return nullptr;
+  auto r = std::make_shared<Ring>(cap_);
+  rings_[owned_.size()].store(r.get(), std::memory_order_release);
+  owned_.push_back(r);
+  ring_count_.store(owned_.size(), std::memory_order_release);
+  return r;
+}
+
+FlightRecorder::Ring* FlightRecorder::ring() {
+  // Hands the ring back when the thread exits.
+  struct Handle {
+    std::uint64_t recorder_id;
+    std::shared_ptr<Ring> ring;
+
+    Handle(std::uint64_t id, std::shared_ptr<Ring> r)
+        : recorder_id(id), ring(std::move(r)) {}
+    Handle(Handle&&) = default;
+    Handle& operator=(Handle&&) = default;
+    ~Handle() {
+      if (ring) ring->owned.store(false, std::memory_order_release);
+    }
+  };
+  struct Cache {
+    std::uint64_t last_id = 0;
+    Ring* last = nullptr;
+    std::vector<Handle> handles;
+  };
+  thread_local Cache cache;
+
+  if (cache.last_id == id_) return cache.last;
+  for (auto& h : cache.handles) {
+    if (h.recorder_id == id_) {
+      cache.last_id = id_;
+      cache.last = h.ring.get();
+      return cache.last;
+    }
+  }
+
+  // Forget recorders that are gone (we hold the last reference).
+  cache.handles.erase(
+      std::remove_if(cache.handles.begin(), cache.handles.end(),
+                     [](const Handle& h) { return h.ring.use_count() <= 1; }),
+      cache.handles.end());
+
+  // A thread that records is one whose crash we want dumped.
+  if (g_installed.load(std::memory_order_acquire)) ensure_alt_stack();
+
+  // A thread that finds no free ring stays unrecorded (last == nullptr).
+  cache.handles.emplace_back(id_, claim_ring());
+  cache.last_id = id_;
+  cache.last = cache.handles.back().ring.get();
+  return cache.last;
+}
+
+void FlightRecorder::record(const LogMessage& msg) {
+  Ring* r = ring();
+  if (r == nullptr) {
+    unrecorded_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  const std::uint64_t h = r->head.load(std::memory_order_relaxed);
+  Slot& s = r->slots[h % cap_];
+  const std::uint32_t seq = s.seq.load(std::memory_order_relaxed);
+  s.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const std::size_t n = std::min(msg.text.size(), sizeof(s.data));
+  s.level = static_cast<std::uint8_t>(msg.level);
+  s.flags = static_cast<std::uint8_t>(
+      (msg.deferred() ? Slot::kDeferred : 0) |
+      (n < msg.text.size() ? Slot::kTruncated : 0));
+  s.len = static_cast<std::uint16_t>(n);
+  s.module = msg.module.id();
+  s.ts_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                msg.ts.time_since_epoch())
+                .count();
+  s.fmt = msg.fmt;
+  std::memcpy(s.data, msg.text.data(), n);
+
+  s.seq.store(seq + 2, std::memory_order_release);
+  r->head.store(h + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::read_ts(const Ring& r, std::uint64_t k,
+                             std::int64_t& ts_ns) const {
+  const Slot& s = r.slots[k % cap_];
+  const auto want = static_cast<std::uint32_t>(2 * (k / cap_ + 1));
+  if (s.seq.load(std::memory_order_acquire) != want) return false;
+  ts_ns = s.ts_ns;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return s.seq.load(std::memory_order_relaxed) == want;
+}
+
+bool FlightRecorder::read_record(const Ring& r, std::uint64_t k,
+                                 Slot& out) const {
+  const Slot& s = r.slots[k % cap_];
+  const auto want = static_cast<std::uint32_t>(2 * (k / cap_ + 1));
+  if (s.seq.load(std::memory_order_acquire) != want) return false;
+  out.level = s.level;
+  out.flags = s.flags;
+  out.len = std::min<std::uint16_t>(s.len, sizeof(out.data));
+  out.module = s.module;
+  out.ts_ns = s.ts_ns;
+  out.fmt = s.fmt;
+  std::memcpy(out.data, s.data, out.len);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return s.seq.load(std::memory_order_relaxed) == want;
+}
+
+bool FlightRecorder::dump(const char* reason) const {
+  std::scoped_lock lk(dump_mutex_);
+  return write_dump(reason);
+}
+
+// Merges the rings oldest-first: each ring is in write order, so holding a
+// cursor per ring and always emitting the oldest head orders the output.
+bool FlightRecorder::write_dump(const char* reason) const {
+  const int fd =
+      ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd < 0) return false;
+  DumpWriter out(fd);
+
+  const std::size_t n =
+      std::min(ring_count_.load(std::memory_order_acquire), kMaxThreads);
+  const Ring* rings[kMaxThreads];
+  std::uint64_t next[kMaxThreads];
+  std::uint64_t end[kMaxThreads];
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    rings[i] = rings_[i].load(std::memory_order_acquire);
+    end[i] = rings[i] != nullptr ? rings[i]->head.load(std::memory_order_acquire)
+                                 : 0;
+    next[i] = end[i] > cap_ ? end[i] - cap_ : 0;
+    total += end[i] - next[i];
+  }
+
+  out.put("==== rover_logger flight recorder: ");
+  out.put(reason != nullptr ? reason : "dump");
+  out.put(" (pid ");
+  out.put_uint(static_cast<std::uint64_t>(::getpid()));
+  out.put(", ");
+  out.put_uint(n);
+  out.put(" threads, ");
+  out.put_uint(total);
+  out.put(" records) ====\n");
+
+  Slot rec;
+  for (;;) {
+    std::size_t oldest = n;
+    std::int64_t oldest_ts = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      std::int64_t ts = 0;
+      // Skip records the owner overwrote since we looked.
+      while (next[i] < end[i] && !read_ts(*rings[i], next[i], ts)) ++next[i];
+      if (next[i] < end[i] && (oldest == n || ts < oldest_ts)) {
+        oldest = i;
+        oldest_ts = ts;
+      }
+    }
+    if (oldest == n) break;
+
+    if (read_record(*rings[oldest], next[oldest]++, rec)) {
+      out.put_timestamp(rec.ts_ns);
+      out.put(' ');
+      out.put(to_string(static_cast<LogLevel>(rec.level)));
+      out.put(" [");
+      out.put(ModuleRegistry::instance().name(rec.module));
+      out.put("] ");
+      if ((rec.flags & Slot::kDeferred) != 0 && rec.fmt != nullptr) {
+        put_deferred(out, rec.fmt, rec.data, rec.len);
+      } else {
+        out.put(rec.data, rec.len);
+        if ((rec.flags & Slot::kTruncated) != 0) out.put("...");
+      }
+      out.put('\n');
+    }
+  }
+  out.put("==== end of flight recorder dump ====\n");
+
+  const bool ok = out.flush();
+  ::fsync(fd);
+  ::close(fd);
+  return ok;
+}
+
+void FlightRecorder::on_crash_signal(int sig) {
+  const int saved_errno = errno;
+  // Only the first crashing thread dumps; a fault inside the dump itself
+  // falls through to the previous handler.
+  if (!g_crashing.exchange(true)) {
+    for (auto& g : g_recorders) {
+      if (const FlightRecorder* r = g.load(std::memory_order_acquire)) {
+        r->write_dump(signal_name(sig));
+      }
+    }
+  }
+  for (std::size_t i = 0; i < kNumCrashSignals; ++i) {
+    if (kCrashSignals[i] == sig) ::sigaction(sig, &g_previous[i], nullptr);
+  }
+  errno = saved_errno;
+  // Blocked until we return, then delivered to the restored handler. A
+  // hardware fault would also simply re-trigger.
+  ::raise(sig);
+}
+
+void FlightRecorder::install_crash_handlers() {
+  ensure_alt_stack();
+  if (g_installed.exchange(true)) return;
+
+  struct sigaction sa {};
+  sa.sa_handler = &FlightRecorder::on_crash_signal;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_ONSTACK;
+  for (std::size_t i = 0; i < kNumCrashSignals; ++i) {
+    ::sigaction(kCrashSignals[i], &sa, &g_previous[i]);
+  }
+}
+
+}  // namespace rover_logger
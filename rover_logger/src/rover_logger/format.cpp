@@ -0,0 +1,165 @@
+#include "rover_logger/format.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace rover_logger {
+
+void TextWriter::grow(std::size_t n) {
+  // Keep what was written; the rest of the old buffer is scratch.
+  out_.truncate(len_);
+  cap_ = std::max(len_ + n, cap_ * 2);
+  buf_ = out_.resize_keep(cap_);
+}
+
+void TextWriter::append_padded(std::string_view s, const FormatSpec& spec,
+                               char align) {
+  const auto width = static_cast<std::size_t>(spec.width);
+  if (width <= s.size()) {
+    append(s);
+    return;
+  }
+  const std::size_t pad = width - s.size();
+  std::size_t before = 0;
+  switch (spec.align != 0 ? spec.align : align) {
+    case '>':
+      before = pad;
+      break;
+    case '^':
+      before = pad / 2;
+      break;
+    default:
+      break;
+  }
+  append(spec.fill, before);
+  append(s);
+  append(spec.fill, pad - before);
+}
+
+namespace {
+
+// s is a rendered number whose first head chars are sign and base prefix.
+// Zero padding goes between those and the digits; otherwise it pads like
+// any other field, right-aligned by default.
+void write_number(TextWriter& out, std::string_view s, std::size_t head,
+                  const FormatSpec& spec) {
+  const auto width = static_cast<std::size_t>(spec.width);
+  if (spec.zero && spec.align == 0 && width > s.size()) {
+    out.append(s.substr(0, head));
+    out.append('0', width - s.size());
+    out.append(s.substr(head));
+    return;
+  }
+  out.append_padded(s, spec, '>');
+}
+
+void to_upper(char* first, char* last) {
+  for (; first != last; ++first) {
+    if (*first >= 'a' && *first <= 'z') {
+      *first = static_cast<char>(*first - 'a' + 'A');
+    }
+  }
+}
+
+template <class F>
+void write_floating(TextWriter& out, F v, const FormatSpec& spec) {
+  // Sign + 309 integer digits + '.' + kMaxPrecision fits comfortably.
+  char buf[512];
+  char* p = buf;
+  if (!std::signbit(v) && (spec.sign == '+' || spec.sign == ' ')) {
+    *p++ = spec.sign;
+  }
+  char* const end = buf + sizeof(buf);
+  const int precision = spec.precision;
+
+  std::to_chars_result r{};
+  switch (spec.type) {
+    case 'f':
+    case 'F':
+      r = std::to_chars(p, end, v, std::chars_format::fixed,
+                        precision < 0 ? 6 : precision);
+      break;
+    case 'e':
+    case 'E':
+      r = std::to_chars(p, end, v, std::chars_format::scientific,
+                        precision < 0 ? 6 : precision);
+      break;
+    case 'g':
+    case 'G':
+      r = std::to_chars(p, end, v, std::chars_format::general,
+                        precision < 0 ? 6 : precision);
+      break;
+    default:
+      r = precision < 0 ? std::to_chars(p, end, v)
+                        : std::to_chars(p, end, v, std::chars_format::general,
+                                        precision);
+      break;
+  }
+  if (r.ec != std::errc()) {
+    out.append("(float)");
+    return;
+  }
+  if (spec.type == 'F' || spec.type == 'E' || spec.type == 'G') {
+    to_upper(p, r.ptr);
+  }
+  const std::size_t head = (p != buf || *p == '-') ? 1 : 0;
+  const std::string_view s(buf, static_cast<std::size_t>(r.ptr - buf));
+  write_number(out, s, std::isfinite(v) ? head : 0, spec);
+}
+
+}  // namespace
+
+void write_int(TextWriter& out, std::uint64_t magnitude, bool negative,
+               const FormatSpec& spec) {
+  char buf[72];  // sign, "0b" and 64 binary digits
+  char* p = buf;
+  if (negative) {
+    *p++ = '-';
+  } else if (spec.sign == '+' || spec.sign == ' ') {
+    *p++ = spec.sign;
+  }
+
+  int base = 10;
+  std::string_view prefix;
+  switch (spec.type) {
+    case 'x':
+      base = 16;
+      prefix = "0x";
+      break;
+    case 'X':
+      base = 16;
+      prefix = "0X";
+      break;
+    case 'o':
+      base = 8;
+      prefix = magnitude != 0 ? "0" : "";
+      break;
+    case 'b':
+      base = 2;
+      prefix = "0b";
+      break;
+    default:
+      break;
+  }
+  if (spec.alt && !prefix.empty()) {
+    std::memcpy(p, prefix.data(), prefix.size());
+    p += prefix.size();
+  }
+  const std::size_t head = static_cast<std::size_t>(p - buf);
+  const auto r = std::to_chars(p, buf + sizeof(buf), magnitude, base);
+  if (spec.type == 'X') to_upper(p, r.ptr);
+  write_number(out,
+               std::string_view(buf, static_cast<std::size_t>(r.ptr - buf)),
+               head, spec);
+}
+
+void write_float(TextWriter& out, double v, const FormatSpec& spec) {
+  write_floating(out, v, spec);
+}
+
+void write_float(TextWriter& out, float v, const FormatSpec& spec) {
+  write_floating(out, v, spec);
+}
+
+}  // namespace rover_logger
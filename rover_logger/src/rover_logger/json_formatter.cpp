@@ -1,81 +1,265 @@
 #include "rover_logger/json_formatter.hpp"
 
+#include <charconv>
 #include <chrono>
 #include <cstdio>
 #include <ctime>
-#include <iomanip>
-#include <sstream>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define ROVER_JSON_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define ROVER_JSON_SIMD_X86 0
+#endif
 
 namespace rover_logger {
 
+namespace {
+
+// Bytes that need escaping: '"', '\\' and control characters (< 0x20).
+inline bool needs_escape(unsigned char c) {
+  return c == '"' || c == '\\' || c < 0x20;
+}
+
+// Each scanner returns the offset of the first byte in [p, p + n) that
+// needs escaping, or n if there is none.
+std::size_t scan_scalar(const char* p, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    if (needs_escape(static_cast<unsigned char>(p[i]))) return i;
+  }
+  return n;
+}
+
+#if ROVER_JSON_SIMD_X86
+// SSE2 is part of x86-64, so this needs no runtime check.
+std::size_t scan_sse2(const char* p, std::size_t n) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i bslash = _mm_set1_epi8('\\');
+  const __m128i ctrl = _mm_set1_epi8(0x1F);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    // v <= 0x1F (unsigned) <=> max(v, 0x1F) == 0x1F
+    const __m128i hit = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash)),
+        _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl));
+    const int mask = _mm_movemask_epi8(hit);
+    if (mask != 0) return i + static_cast<std::size_t>(__builtin_ctz(mask));
+  }
+  return i + scan_scalar(p + i, n - i);
+}
+
+__attribute__((target("avx2"))) std::size_t scan_avx2(const char* p,
+                                                      std::size_t n) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i bslash = _mm256_set1_epi8('\\');
+  const __m256i ctrl = _mm256_set1_epi8(0x1F);
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+    const __m256i hit = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                        _mm256_cmpeq_epi8(v, bslash)),
+        _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl), ctrl));
+    const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+    if (mask != 0) return i + static_cast<std::size_t>(__builtin_ctz(mask));
+  }
+  // The tail stays in this function on purpose: calling the (non-VEX)
+  // SSE2 scanner with dirty upper YMM state costs a transition penalty
+  // far larger than the scan itself.
+  for (; i < n; ++i) {
+    if (needs_escape(static_cast<unsigned char>(p[i]))) return i;
+  }
+  return n;
+}
+#endif
+
+using ScanFn = std::size_t (*)(const char*, std::size_t);
+
+ScanFn pick_scanner() {
+#if ROVER_JSON_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return scan_avx2;
+  return scan_sse2;
+#else
+  return scan_scalar;
+#endif
+}
+
+// Chosen once, during static initialization.
+const ScanFn scan_for_escape = pick_scanner();
+
+void append_escape(std::string& out, unsigned char c) {
+  switch (c) {
+    case '\"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\b':
+      out += "\\b";
+      break;
+    case '\f':
+      out += "\\f";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\r':
+      out += "\\r";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default: {
+      static constexpr char kHex[] = "0123456789ABCDEF";
+      const char buf[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+      out.append(buf, sizeof(buf));
+    }
+  }
+}
+
+}  // namespace
+
+void append_json_escaped(std::string& out, std::string_view s) {
+  // Null only if called from another file's static initializer.
+  const ScanFn scan = scan_for_escape ? scan_for_escape : scan_scalar;
+  const char* p = s.data();
+  std::size_t n = s.size();
+  while (n > 0) {
+    // Most log text has nothing to escape, so this is usually one scan
+    // and one bulk copy.
+    const std::size_t clean = scan(p, n);
+    out.append(p, clean);
+    if (clean == n) break;
+    append_escape(out, static_cast<unsigned char>(p[clean]));
+    p += clean + 1;
+    n -= clean + 1;
+  }
+}
+
 std::string json_escape(std::string_view s) {
   std::string out;
   out.reserve(s.size() + 8);
-  for (unsigned char c : s) {
-    switch (c) {
-      case '\"':
-        out += "\\\"";
-        break;
-      case '\\':
-        out += "\\\\";
-        break;
-      case '\b':
-        out += "\\b";
-        break;
-      case '\f':
-        out += "\\f";
-        break;
-      case '\n':
-        out += "\\n";
-        break;
-      case '\r':
-        out += "\\r";
-        break;
-      case '\t':
-        out += "\\t";
-        break;
-      default:
-        if (c < 0x20) {
-          char buf[7];
-          std::snprintf(buf, sizeof(buf), "\\u%04X", c);
-          out += buf;
-        } else {
-          out.push_back(static_cast<char>(c));
-        }
-    }
-  }
+  append_json_escaped(out, s);
   return out;
 }
 
-std::string iso8601_utc_ms(const LogMessage::clock::time_point& tp) {
+namespace {
+
+// Writes value as exactly width decimal digits (zero padded).
+void append_digits(std::string& out, std::uint64_t value, int width) {
+  char buf[20];
+  for (int i = width - 1; i >= 0; --i) {
+    buf[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  out.append(buf, static_cast<std::size_t>(width));
+}
+
+void append_int(std::string& out, std::int64_t value) {
+  char buf[24];
+  const auto res = std::to_chars(buf, buf + sizeof(buf), value);
+  out.append(buf, res.ptr);
+}
+
+// Thread-local formatter behind the free functions, so callers that don't
+// own one still get the per-second prefix cache.
+TimestampFormatter& thread_iso8601_ms() {
+  thread_local TimestampFormatter fmt(TimestampFormat::Iso8601Millis);
+  return fmt;
+}
+
+}  // namespace
+
+bool TimestampFormatter::is_integer() const {
+  return fmt_ == TimestampFormat::EpochMillis ||
+         fmt_ == TimestampFormat::EpochMicros ||
+         fmt_ == TimestampFormat::EpochNanos;
+}
+
+void TimestampFormatter::append(std::string& out,
+                                const LogMessage::clock::time_point& tp) {
   using namespace std::chrono;
-  auto t = LogMessage::clock::to_time_t(tp);
-  std::tm tm{};
+  const std::int64_t ns = duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+
+  switch (fmt_) {
+    case TimestampFormat::EpochMillis:
+      append_int(out, ns / 1000000);
+      return;
+    case TimestampFormat::EpochMicros:
+      append_int(out, ns / 1000);
+      return;
+    case TimestampFormat::EpochNanos:
+      append_int(out, ns);
+      return;
+    default:
+      break;
+  }
+
+  // Floor division so pre-1970 times still get a non-negative fraction.
+  std::int64_t sec = ns / 1000000000;
+  std::int64_t frac = ns % 1000000000;
+  if (frac < 0) {
+    frac += 1000000000;
+    --sec;
+  }
+
+  if (sec != cached_sec_) {
+    const auto t = static_cast<std::time_t>(sec);
+    std::tm tm{};
 #if defined(_WIN32)
-  gmtime_s(&tm, &t);
+    gmtime_s(&tm, &t);
 #else
-  gmtime_r(&t, &tm);
+    gmtime_r(&t, &tm);
 #endif
-  auto ms = duration_cast<milliseconds>(tp.time_since_epoch()) % 1000;
+    std::strftime(prefix_, sizeof(prefix_), "%Y-%m-%dT%H:%M:%S", &tm);
+    cached_sec_ = sec;
+  }
 
-  std::ostringstream oss;
-  oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S") << '.' << std::setw(3)
-      << std::setfill('0') << ms.count() << 'Z';
-  return oss.str();
+  out.append(prefix_);
+  out.push_back('.');
+  if (fmt_ == TimestampFormat::Iso8601Millis) {
+    append_digits(out, static_cast<std::uint64_t>(frac / 1000000), 3);
+  } else if (fmt_ == TimestampFormat::Iso8601Micros) {
+    append_digits(out, static_cast<std::uint64_t>(frac / 1000), 6);
+  } else {
+    append_digits(out, static_cast<std::uint64_t>(frac), 9);
+  }
+  out.push_back('Z');
+}
+
+std::string iso8601_utc_ms(const LogMessage::clock::time_point& tp) {
+  std::string out;
+  thread_iso8601_ms().append(out, tp);
+  return out;
+}
+
+void append_json_line(std::string& out, const LogMessage& msg,
+                      TimestampFormatter& ts) {
+  out.reserve(out.size() + 64 + msg.module.size() + msg.text.size());
+  if (ts.is_integer()) {
+    out += "{\"ts\":";
+    ts.append(out, msg.ts);
+    out += ",\"level\":\"";
+  } else {
+    out += "{\"ts\":\"";
+    ts.append(out, msg.ts);
+    out += "\",\"level\":\"";
+  }
+  out += to_string(msg.level);
+  out += "\",\"module\":\"";
+  append_json_escaped(out, msg.module);
+  out += "\",\"message\":\"";
+  append_json_escaped(out, msg.text);
+  out += "\"}";
 }
 
 std::string to_json_line(const LogMessage& msg) {
   std::string j;
-  j.reserve(64 + msg.module.size() + msg.text.size());
-  j += "{\"ts\":\"";
-  j += iso8601_utc_ms(msg.ts);
-  j += "\",\"level\":\"";
-  j += std::string(to_string(msg.level));
-  j += "\",\"module\":\"";
-  j += json_escape(msg.module);
-  j += "\",\"message\":\"";
-  j += json_escape(msg.text);
-  j += "\"}";
+  append_json_line(j, msg, thread_iso8601_ms());
   return j;
 }
 
@@ -0,0 +1,115 @@
+#include "rover_logger/log_compactor.hpp"
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace rover_logger {
+
+LogCompactor::LogCompactor(LogCompactorOptions opt) : opt_(std::move(opt)) {
+  thread_ = std::thread(&LogCompactor::run, this);
+}
+
+LogCompactor::~LogCompactor() {
+  {
+    std::scoped_lock lk(m_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+void LogCompactor::notify_rotated(int index) {
+  {
+    std::scoped_lock lk(m_);
+    jobs_.push_back(index);
+  }
+  cv_.notify_one();
+}
+
+void LogCompactor::wait_idle() {
+  std::unique_lock lk(m_);
+  idle_cv_.wait(lk, [&] { return jobs_.empty() && !busy_; });
+}
+
+std::string LogCompactor::file_name(int index) const {
+  return opt_.base_filename + "_" + std::to_string(index) + ".log";
+}
+
+// Streams path into path.gz (via a temp file, so a crash never leaves a
+// truncated .gz behind) and removes the original on success.
+bool LogCompactor::compress_file(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+
+  const std::string gz_path = path + ".gz";
+  const std::string tmp_path = gz_path + ".tmp";
+  const std::string mode = "wb" + std::to_string(opt_.level);
+  gzFile out = gzopen(tmp_path.c_str(), mode.c_str());
+  if (out == nullptr) return false;
+
+  std::vector<char> buf(64 * 1024);
+  bool ok = true;
+  while (ok && in) {
+    in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+    const auto n = static_cast<unsigned>(in.gcount());
+    if (n > 0 && gzwrite(out, buf.data(), n) != static_cast<int>(n)) ok = false;
+  }
+  if (gzclose(out) != Z_OK) ok = false;
+
+  if (!ok || std::rename(tmp_path.c_str(), gz_path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  std::remove(path.c_str());
+  return true;
+}
+
+// Keeps the `keep` newest rotated files (indices newest-keep+1..newest).
+void LogCompactor::apply_retention(int newest_rotated) {
+  if (opt_.keep < 0) return;
+  const int first_kept = newest_rotated - opt_.keep + 1;
+  for (; retained_floor_ < first_kept; ++retained_floor_) {
+    const std::string path = file_name(retained_floor_);
+    std::remove(path.c_str());
+    std::remove((path + ".gz").c_str());
+  }
+}
+
+void LogCompactor::run() {
+#if defined(__linux__)
+  // Linux applies niceness per thread; only this compaction thread is
+  // deprioritised.
+  setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)),
+              opt_.nice);
+#endif
+
+  std::unique_lock lk(m_);
+  for (;;) {
+    cv_.wait(lk, [&] { return stop_ || !jobs_.empty(); });
+    if (jobs_.empty()) break;  // stop requested and nothing pending
+
+    const int index = jobs_.front();
+    jobs_.pop_front();
+    busy_ = true;
+    lk.unlock();
+
+    if (opt_.compress && opt_.keep != 0) compress_file(file_name(index));
+    apply_retention(index);
+
+    lk.lock();
+    busy_ = false;
+    if (jobs_.empty()) idle_cv_.notify_all();
+  }
+}
+
+}  // namespace rover_logger
@@ -1,2 +1,148 @@
 #include "rover_logger/log_message.hpp"
-namespace rover_logger {}
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace rover_logger {
+
+namespace {
+
+// Recycles overflow blocks for long lines. Long lines are the exception,
+// so a mutex-protected free list is cheap enough here and keeps the
+// steady state free of malloc/free. Lines beyond kBlockSize are rare
+// enough to go straight to the heap.
+class OverflowPool {
+ public:
+  static constexpr std::size_t kBlockSize = 4096;
+  static constexpr std::size_t kMaxCached = 256;
+
+  // Intentionally leaked: messages may be destroyed during static
+  // destruction (e.g. a global Logger draining at exit).
+  static OverflowPool& instance() {
+    static OverflowPool* pool = new OverflowPool;
+    return *pool;
+  }
+
+  char* acquire(std::size_t n, std::uint32_t& cap) {
+    if (n > kBlockSize) {
+      cap = static_cast<std::uint32_t>(n);
+      return new char[n];
+    }
+    cap = kBlockSize;
+    {
+      std::scoped_lock lk(m_);
+      if (!free_.empty()) {
+        char* p = free_.back();
+        free_.pop_back();
+        return p;
+      }
+    }
+    return new char[kBlockSize];
+  }
+
+  void release(char* p, std::uint32_t cap) {
+    if (cap == kBlockSize) {
+      std::scoped_lock lk(m_);
+      if (free_.size() < kMaxCached) {
+        free_.push_back(p);
+        return;
+      }
+    }
+    delete[] p;
+  }
+
+ private:
+  std::mutex m_;
+  std::vector<char*> free_;
+};
+
+}  // namespace
+
+MessageText::MessageText(const MessageText& other) { assign(other.view()); }
+
+MessageText::MessageText(MessageText&& other) noexcept
+    : size_(other.size_),
+      overflow_cap_(other.overflow_cap_),
+      overflow_(other.overflow_) {
+  if (overflow_ == nullptr) std::memcpy(inline_, other.inline_, size_);
+  other.size_ = 0;
+  other.overflow_cap_ = 0;
+  other.overflow_ = nullptr;
+}
+
+MessageText& MessageText::operator=(const MessageText& other) {
+  if (this != &other) assign(other.view());
+  return *this;
+}
+
+MessageText& MessageText::operator=(MessageText&& other) noexcept {
+  if (this == &other) return *this;
+  release();
+  size_ = other.size_;
+  overflow_cap_ = other.overflow_cap_;
+  overflow_ = other.overflow_;
+  if (overflow_ == nullptr) std::memcpy(inline_, other.inline_, size_);
+  other.size_ = 0;
+  other.overflow_cap_ = 0;
+  other.overflow_ = nullptr;
+  return *this;
+}
+
+void MessageText::assign(std::string_view s) {
+  char* dst = resize_for_write(s.size());
+  if (!s.empty()) std::memcpy(dst, s.data(), s.size());
+}
+
+char* MessageText::resize_for_write(std::size_t n) {
+  if (n + 1 <= kInlineCapacity) {
+    release();
+    size_ = static_cast<std::uint32_t>(n);
+    return inline_;
+  }
+  if (overflow_ == nullptr || overflow_cap_ < n + 1) {
+    release();
+    overflow_ = OverflowPool::instance().acquire(n + 1, overflow_cap_);
+  }
+  size_ = static_cast<std::uint32_t>(n);
+  return overflow_;
+}
+
+char* MessageText::resize_keep(std::size_t n) {
+  const std::size_t cap =
+      overflow_ != nullptr ? overflow_cap_ : kInlineCapacity;
+  if (n + 1 <= cap) {
+    size_ = static_cast<std::uint32_t>(n);
+    return overflow_ != nullptr ? overflow_ : inline_;
+  }
+  std::uint32_t block_cap = 0;
+  char* block = OverflowPool::instance().acquire(n + 1, block_cap);
+  const std::size_t keep = std::min<std::size_t>(size_, n);
+  if (keep != 0) std::memcpy(block, data(), keep);
+  release();
+  overflow_ = block;
+  overflow_cap_ = block_cap;
+  size_ = static_cast<std::uint32_t>(n);
+  return overflow_;
+}
+
+void MessageText::release() {
+  if (overflow_ != nullptr) {
+    OverflowPool::instance().release(overflow_, overflow_cap_);
+    overflow_ = nullptr;
+    overflow_cap_ = 0;
+  }
+  size_ = 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const ModuleName& m) {
+  return os << m.view();
+}
+
+std::ostream& operator<<(std::ostream& os, const MessageText& t) {
+  return os << t.view();
+}
+
+}  // namespace rover_logger
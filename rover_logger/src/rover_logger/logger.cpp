@@ -1,8 +1,107 @@
 #include "rover_logger/logger.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <optional>
+
+#include "rover_logger/deferred_format.hpp"
+
 namespace rover_logger {
 
-Logger::Logger(std::size_t max_queue) : queue_(max_queue) {
+namespace {
+std::atomic<std::uint64_t> g_next_logger_id{1};
+
+// The Logger whose worker or sink thread this is. Such threads must not
+// take the emergency path: they may already hold the locks it needs.
+thread_local const Logger* t_writer = nullptr;
+
+LoggerConfig queue_only_config(std::size_t max_queue, QueueMode mode) {
+  LoggerConfig cfg;
+  cfg.max_queue = max_queue;
+  cfg.queue_mode = mode;
+  return cfg;
+}
+
+std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point t0) {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - t0)
+          .count());
+}
+
+// Calls f on each interned ancestor of module, nearest first ("/a/b/c" ->
+// "/a/b" -> "/a"), until it returns true. Lock-free: names and ids are
+// immutable once interned, and a prefix nobody interned cannot carry
+// configuration.
+template <class F>
+void walk_ancestors(ModuleId module, F&& f) {
+  const ModuleRegistry& reg = ModuleRegistry::instance();
+  std::string_view path = reg.name(module);
+  for (std::size_t cut = path.rfind('/'); cut != 0 && cut != path.npos;
+       cut = path.rfind('/')) {
+    path = path.substr(0, cut);
+    const ModuleId parent = reg.find(path);
+    if (parent != ModuleRegistry::kUnknown && f(parent)) return;
+  }
+}
+
+// Feeds every kEvery-th message's queueing delay into h. next carries the
+// sampling phase across batches.
+template <std::uint64_t kEvery>
+void sample_latency(Histogram& h, std::uint64_t& next, const LogMessage* msgs,
+                    std::size_t count) {
+  const auto now = LogMessage::clock::now();
+  for (; next < count; next += kEvery) {
+    const auto waited = now - msgs[next].ts;
+    h.record(static_cast<std::uint64_t>(std::max<std::int64_t>(
+        0, std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count())));
+  }
+  next -= count;
+}
+}  // namespace
+
+Logger::Logger(std::size_t max_queue, QueueMode mode)
+    : Logger(queue_only_config(max_queue, mode)) {}
+
+Logger::Logger(const LoggerConfig& cfg)
+    : mode_(cfg.queue_mode),
+      overflow_(cfg.overflow),
+      block_timeout_(std::chrono::milliseconds(cfg.block_timeout_ms)),
+      dispatch_(cfg.dispatch),
+      sink_queue_cap_(cfg.sink_queue == 0 ? cfg.max_queue : cfg.sink_queue),
+      queue_cap_(cfg.max_queue),
+      batch_max_(cfg.batch_max == 0 ? 1 : cfg.batch_max),
+      batch_linger_(std::chrono::milliseconds(cfg.batch_linger_ms)),
+      flush_interval_(cfg.flush_interval_ms),
+      emergency_level_(cfg.emergency_level),
+      id_(g_next_logger_id.fetch_add(1, std::memory_order_relaxed)),
+      record_level_(cfg.flight_recorder.enabled
+                        ? static_cast<int>(cfg.flight_recorder.level)
+                        : static_cast<int>(kLevelCount)),
+      dump_on_exit_(cfg.flight_recorder.enabled &&
+                    cfg.flight_recorder.dump_on_exit),
+      // The shared queue is unused in per-thread mode; keep it minimal.
+      queue_(cfg.queue_mode == QueueMode::Shared ? cfg.max_queue : 1) {
+  for (auto& lv : module_levels_) {
+    lv.store(kInheritLevel, std::memory_order_relaxed);
+  }
+  for (auto& r : resolved_levels_) r.store(0, std::memory_order_relaxed);
+  for (auto& l : module_limiters_) l.store(nullptr, std::memory_order_relaxed);
+  for (auto& r : resolved_limiters_) r.store(0, std::memory_order_relaxed);
+  for (auto& c : module_msgs_) c.store(0, std::memory_order_relaxed);
+  for (auto& c : module_bytes_) c.store(0, std::memory_order_relaxed);
+  last_snapshot_ = std::chrono::steady_clock::now();
+
+  if (cfg.flight_recorder.enabled) {
+    recorder_ = std::make_unique<FlightRecorder>(
+        cfg.flight_recorder.path, cfg.flight_recorder.records_per_thread);
+    if (cfg.flight_recorder.on_signal) FlightRecorder::install_crash_handlers();
+    // Let filtered-out messages through level_enabled() to the recorder.
+    std::scoped_lock lk(modules_mutex_);
+    recompute_floor_locked();
+  }
+
   // Start the background worker thread.
   worker_ = std::thread(&Logger::worker, this);
 }
@@ -11,62 +110,843 @@ Logger::~Logger() {
   // Ask worker to stop, then drain/flush.
   running_.store(false, std::memory_order_relaxed);
   queue_.request_stop();
+  bell_.wake_all();
   if (worker_.joinable()) worker_.join();
-  for (auto& s : sinks_) s->flush();
+  // The worker has fanned out everything; let the sink threads drain.
+  stop_sink_workers();
+  for (auto& s : sinks_) {
+    deliver_due(*s, true);
+    s->sink->flush();
+  }
+  if (dump_on_exit_) recorder_->dump("shutdown");
+}
+
+bool Logger::dump_flight_recorder(const char* reason) {
+  return recorder_ != nullptr && recorder_->dump(reason);
+}
+
+void Logger::add_sink(std::shared_ptr<ILogSink> sink,
+                      const CoalesceConfig& coalesce) {
+  auto slot = std::make_unique<SinkSlot>(std::move(sink));
+  if (coalesce.enabled()) {
+    slot->coalescer = std::make_unique<Coalescer>(
+        std::chrono::milliseconds(coalesce.window_ms), coalesce.max_entries);
+  }
+  if (dispatch_ == DispatchMode::PerSink) {
+    slot->queue = std::make_unique<Queue>(sink_queue_cap_);
+    slot->thread = std::thread(&Logger::sink_worker, this, std::ref(*slot));
+  }
+  sinks_.push_back(std::move(slot));
+}
+
+void Logger::stop_sink_workers() {
+  for (auto& s : sinks_) {
+    if (s->queue) s->queue->request_stop();
+  }
+  for (auto& s : sinks_) {
+    if (s->thread.joinable()) s->thread.join();
+  }
+}
+
+void Logger::set_min_level(LogLevel lv) {
+  std::scoped_lock lk(modules_mutex_);
+  min_level_.store(lv, std::memory_order_relaxed);
+  recompute_floor_locked();
 }
 
 void Logger::set_module_level(const std::string& module, LogLevel lv) {
+  const ModuleId id = ModuleRegistry::instance().intern(module);
   std::scoped_lock lk(modules_mutex_);
-  module_min_levels_[module] = lv;
+  module_min_levels_[id] = lv;
+  store_module_level_locked(id, static_cast<std::int8_t>(lv));
+  publish_module_levels_locked();
 }
 
 void Logger::clear_module_level(const std::string& module) {
+  const ModuleId id = ModuleRegistry::instance().intern(module);
   std::scoped_lock lk(modules_mutex_);
-  module_min_levels_.erase(module);
+  module_min_levels_.erase(id);
+  store_module_level_locked(id, kInheritLevel);
+  publish_module_levels_locked();
 }
 
 void Logger::clear_all_module_levels() {
   std::scoped_lock lk(modules_mutex_);
+  for (const auto& [id, lv] : module_min_levels_) {
+    store_module_level_locked(id, kInheritLevel);
+  }
   module_min_levels_.clear();
+  publish_module_levels_locked();
 }
 
 void Logger::apply_module_config(
     const std::unordered_map<std::string, LogLevel>& mods) {
+  std::unordered_map<ModuleId, LogLevel> by_id;
+  for (const auto& [name, lv] : mods) {
+    by_id[ModuleRegistry::instance().intern(name)] = lv;
+  }
+  std::scoped_lock lk(modules_mutex_);
+  // Copy-on-write: readers see each module flip from its old level to its
+  // new one, never a missing entry in between.
+  for (const auto& [id, lv] : by_id) {
+    store_module_level_locked(id, static_cast<std::int8_t>(lv));
+  }
+  for (const auto& [id, lv] : module_min_levels_) {
+    if (by_id.find(id) == by_id.end()) {
+      store_module_level_locked(id, kInheritLevel);
+    }
+  }
+  module_min_levels_ = std::move(by_id);
+  publish_module_levels_locked();
+}
+
+void Logger::store_module_level_locked(ModuleId module, std::int8_t lv) {
+  if (module >= ModuleRegistry::kMaxModules) return;
+  module_levels_[module].store(lv, std::memory_order_relaxed);
+}
+
+// The module's own override, else its nearest ancestor's.
+std::int8_t Logger::resolve_module_level(ModuleId module) const {
+  std::int8_t lv = module_levels_[module].load(std::memory_order_relaxed);
+  if (lv != kInheritLevel || module == ModuleRegistry::kUnknown) return lv;
+  walk_ancestors(module, [&](ModuleId parent) {
+    lv = module_levels_[parent].load(std::memory_order_relaxed);
+    return lv != kInheritLevel;
+  });
+  return lv;
+}
+
+void Logger::set_module_limit(const std::string& module, const ModuleLimit& lim) {
+  const ModuleId id = ModuleRegistry::instance().intern(module);
   std::scoped_lock lk(modules_mutex_);
-  module_min_levels_ = mods;
+  if (lim.active()) {
+    module_limits_[id] = lim;
+    store_module_limit_locked(id, &lim);
+  } else {
+    module_limits_.erase(id);
+    store_module_limit_locked(id, nullptr);
+  }
+  publish_module_limits_locked();
 }
 
-LogLevel Logger::effective_min_level(const std::string& module) const {
+void Logger::clear_module_limit(const std::string& module) {
+  set_module_limit(module, ModuleLimit{});
+}
+
+void Logger::apply_module_limits(
+    const std::unordered_map<std::string, ModuleLimit>& limits) {
+  std::unordered_map<ModuleId, ModuleLimit> by_id;
+  for (const auto& [name, lim] : limits) {
+    if (lim.active()) by_id[ModuleRegistry::instance().intern(name)] = lim;
+  }
   std::scoped_lock lk(modules_mutex_);
-  auto it = module_min_levels_.find(module);
-  if (it != module_min_levels_.end()) {
-    return it->second;
+  for (const auto& [id, lim] : by_id) store_module_limit_locked(id, &lim);
+  for (const auto& [id, lim] : module_limits_) {
+    if (by_id.find(id) == by_id.end()) store_module_limit_locked(id, nullptr);
+  }
+  module_limits_ = std::move(by_id);
+  publish_module_limits_locked();
+}
+
+// A new limiter starts with a full bucket; the one it replaces is kept
+// until the Logger goes away.
+void Logger::store_module_limit_locked(ModuleId module, const ModuleLimit* lim) {
+  if (module >= ModuleRegistry::kMaxModules) return;
+  ModuleLimiter* l = nullptr;
+  if (lim != nullptr) {
+    limiter_store_.push_back(std::make_unique<ModuleLimiter>(*lim));
+    l = limiter_store_.back().get();
+  }
+  module_limiters_[module].store(l, std::memory_order_release);
+}
+
+void Logger::publish_module_limits_locked() {
+  limits_gen_.fetch_add(1, std::memory_order_release);
+  limits_active_.store(!module_limits_.empty(), std::memory_order_relaxed);
+}
+
+Logger::ModuleLimiter* Logger::module_limiter(ModuleId module) const {
+  if (module >= ModuleRegistry::kMaxModules) module = ModuleRegistry::kUnknown;
+  const std::uint64_t gen = limits_gen_.load(std::memory_order_acquire);
+  const std::uint64_t cached =
+      resolved_limiters_[module].load(std::memory_order_relaxed);
+  std::uint64_t owner;  // owning module + 1, 0 for none
+  if ((cached >> 16) == gen) {
+    owner = cached & 0xffff;
+  } else {
+    owner = 0;
+    if (module_limiters_[module].load(std::memory_order_relaxed) != nullptr) {
+      owner = module + 1;
+    } else if (module != ModuleRegistry::kUnknown) {
+      walk_ancestors(module, [&](ModuleId parent) {
+        if (module_limiters_[parent].load(std::memory_order_relaxed) == nullptr) {
+          return false;
+        }
+        owner = parent + 1;
+        return true;
+      });
+    }
+    resolved_limiters_[module].store((gen << 16) | owner,
+                                     std::memory_order_relaxed);
+  }
+  if (owner == 0) return nullptr;
+  return module_limiters_[owner - 1].load(std::memory_order_acquire);
+}
+
+Logger::ModuleLimiter::ModuleLimiter(const ModuleLimit& lim)
+    : sample(lim.sample == 0 ? 1 : lim.sample) {
+  if (lim.rate > 0) {
+    bucket.emplace(lim.rate, lim.burst == 0
+                                 ? std::max<std::size_t>(
+                                       1, static_cast<std::size_t>(lim.rate))
+                                 : lim.burst);
+  }
+}
+
+// Sampling first, so only sampled-in messages spend tokens. A call site is
+// the deferred format string; other messages are sampled per level.
+bool Logger::ModuleLimiter::admit(const LogMessage& msg) {
+  if (sample > 1) {
+    const auto site = msg.deferred()
+                          ? reinterpret_cast<std::uintptr_t>(msg.fmt)
+                          : static_cast<std::uintptr_t>(msg.level);
+    const std::size_t i =
+        static_cast<std::size_t>((site * 0x9E3779B97F4A7C15ull) >> 58) %
+        kSampleSites;
+    if (site_counts[i].fetch_add(1, std::memory_order_relaxed) % sample != 0) {
+      suppressed.add();
+      return false;
+    }
+  }
+  if (bucket && !bucket->try_take(steady_now_ns())) {
+    suppressed.add();
+    return false;
+  }
+  return true;
+}
+
+void Logger::recompute_floor_locked() {
+  int floor = static_cast<int>(min_level_.load(std::memory_order_relaxed));
+  for (const auto& [id, lv] : module_min_levels_) {
+    floor = std::min(floor, static_cast<int>(lv));
+  }
+  floor = std::min(floor, record_level_);
+  floor_level_.store(floor, std::memory_order_relaxed);
+}
+
+void Logger::publish_module_levels_locked() {
+  levels_gen_.fetch_add(1, std::memory_order_release);
+  recompute_floor_locked();
+}
+
+std::array<std::uint64_t, kLevelCount> Logger::dropped_by_level() const {
+  std::array<std::uint64_t, kLevelCount> out{};
+  for (std::size_t i = 0; i < kLevelCount; ++i) {
+    out[i] = drops_.by_level[i].load(std::memory_order_relaxed);
+  }
+  if (mode_ == QueueMode::PerThread) {
+    std::scoped_lock lk(producers_mutex_);
+    for (std::size_t i = 0; i < kLevelCount; ++i) {
+      out[i] += retired_dropped_[i];
+      for (const auto& p : producers_) {
+        out[i] += p->drops.by_level[i].load(std::memory_order_relaxed);
+      }
+    }
+  }
+  return out;
+}
+
+std::uint64_t Logger::dropped_total() const {
+  std::uint64_t total = 0;
+  for (std::uint64_t n : dropped_by_level()) total += n;
+  return total;
+}
+
+std::size_t Logger::queue_size_peak() const {
+  if (mode_ == QueueMode::Shared) return queue_.peak();
+  std::scoped_lock lk(producers_mutex_);
+  std::size_t peak = retired_peak_;
+  for (const auto& p : producers_) peak = std::max(peak, p->queue.peak());
+  return peak;
+}
+
+LoggerMetrics Logger::metrics_snapshot() {
+  LoggerMetrics m;
+  m.taken = std::chrono::system_clock::now();
+  m.processed_total = processed_total();
+  m.suppressed_total = suppressed_total();
+  const auto by_level = dropped_by_level();
+  for (std::size_t i = 0; i < kLevelCount; ++i) {
+    m.dropped_by_level[i] = by_level[i];
+    m.dropped_total += by_level[i];
+  }
+  m.queue_capacity = queue_cap_;
+  m.queue_peak = queue_size_peak();
+  if (mode_ == QueueMode::Shared) {
+    m.queue_depth = queue_.size();
+  } else {
+    std::scoped_lock lk(producers_mutex_);
+    for (const auto& p : producers_) m.queue_depth += p->queue.size();
+  }
+
+  m.enqueue_to_sink_ns = enqueue_to_sink_ns_.summary();
+  m.batch_size = batch_size_.summary();
+  m.sinks.reserve(sinks_.size());
+  for (const auto& s : sinks_) {
+    SinkMetrics sm;
+    sm.name = s->sink->name();
+    sm.write_ns = s->write_ns.summary();
+    sm.written = s->written.load(std::memory_order_relaxed);
+    if (s->coalescer) sm.coalesced = s->coalescer->coalesced();
+    if (s->queue) {
+      for (const auto& d : s->drops.by_level) {
+        sm.dropped += d.load(std::memory_order_relaxed);
+      }
+      sm.queue_depth = s->queue->size();
+      sm.queue_peak = s->queue->peak();
+      sm.enqueue_to_sink_ns = s->enqueue_to_sink_ns.summary();
+    } else {
+      sm.enqueue_to_sink_ns = m.enqueue_to_sink_ns;
+    }
+    m.sinks.push_back(std::move(sm));
+  }
+
+  std::scoped_lock lk(metrics_mutex_);
+  const auto now = std::chrono::steady_clock::now();
+  m.interval_sec = std::chrono::duration<double>(now - last_snapshot_).count();
+  last_snapshot_ = now;
+  last_module_msgs_.resize(ModuleRegistry::kMaxModules, 0);
+  last_module_bytes_.resize(ModuleRegistry::kMaxModules, 0);
+
+  const ModuleRegistry& reg = ModuleRegistry::instance();
+  const std::size_t n = std::min(reg.size(), ModuleRegistry::kMaxModules);
+  for (std::size_t id = 0; id < n; ++id) {
+    const std::uint64_t msgs = module_msgs_[id].load(std::memory_order_relaxed);
+    if (msgs == 0) continue;
+    const std::uint64_t bytes = module_bytes_[id].load(std::memory_order_relaxed);
+    ModuleMetrics mm;
+    mm.module = std::string(reg.name(static_cast<ModuleId>(id)));
+    mm.messages = msgs;
+    mm.bytes = bytes;
+    if (m.interval_sec > 0) {
+      mm.messages_per_sec = (msgs - last_module_msgs_[id]) / m.interval_sec;
+      mm.bytes_per_sec = (bytes - last_module_bytes_[id]) / m.interval_sec;
+    }
+    last_module_msgs_[id] = msgs;
+    last_module_bytes_[id] = bytes;
+    m.modules.push_back(std::move(mm));
+  }
+  std::sort(m.modules.begin(), m.modules.end(),
+            [](const ModuleMetrics& a, const ModuleMetrics& b) {
+              return a.messages_per_sec > b.messages_per_sec;
+            });
+  return m;
+}
+
+Logger::ProducerSlot& Logger::producer_slot() {
+  // Marks the slot orphaned when the producer thread exits so the worker
+  // can reap it once drained.
+  struct Handle {
+    std::uint64_t logger_id;
+    std::shared_ptr<ProducerSlot> slot;
+
+    Handle(std::uint64_t id, std::shared_ptr<ProducerSlot> s)
+        : logger_id(id), slot(std::move(s)) {}
+    Handle(Handle&&) = default;
+    Handle& operator=(Handle&&) = default;
+    ~Handle() {
+      if (slot) slot->orphaned.store(true, std::memory_order_release);
+    }
+  };
+  struct Cache {
+    std::uint64_t last_id = 0;
+    ProducerSlot* last = nullptr;
+    std::vector<Handle> handles;
+  };
+  thread_local Cache cache;
+
+  if (cache.last_id == id_) return *cache.last;
+
+  for (auto& h : cache.handles) {
+    if (h.logger_id == id_) {
+      cache.last_id = id_;
+      cache.last = h.slot.get();
+      return *cache.last;
+    }
+  }
+
+  // First log() from this thread: register a new queue. Drop handles whose
+  // Logger is gone (we hold the last reference).
+  cache.handles.erase(
+      std::remove_if(cache.handles.begin(), cache.handles.end(),
+                     [](const Handle& h) { return h.slot.use_count() == 1; }),
+      cache.handles.end());
+
+  auto slot = std::make_shared<ProducerSlot>(queue_cap_, &bell_);
+  {
+    std::scoped_lock lk(producers_mutex_);
+    producers_.push_back(slot);
   }
-  return min_level_.load(std::memory_order_relaxed);
+  producers_version_.fetch_add(1, std::memory_order_release);
+
+  cache.handles.emplace_back(id_, slot);
+  cache.last_id = id_;
+  cache.last = slot.get();
+  return *cache.last;
 }
 
 void Logger::log(LogMessage msg) {
   // Filter by global+module level first (cheap).
-  LogLevel min_lv = effective_min_level(msg.module);
-  if (static_cast<int>(msg.level) < static_cast<int>(min_lv)) {
+  if (!should_log(msg.level, msg.module.id())) {
+    record(msg);
+    return;
+  }
+  submit(std::move(msg));
+}
+
+void Logger::submit(LogMessage msg) {
+  if (recording(msg.level)) {
+    recorder_->record(msg);
+    if (msg.level == LogLevel::FATAL) recorder_->dump("FATAL");
+  }
+  if (msg.level >= emergency_level_ && t_writer != this) {
+    write_through(std::move(msg));
+    return;
+  }
+  ModuleLimiter* lim = nullptr;
+  if (limits_active_.load(std::memory_order_relaxed)) {
+    lim = module_limiter(msg.module.id());
+    if (lim != nullptr && !lim->admit(msg)) {
+      suppressed_total_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  if (lim == nullptr || !lim->suppressed.pending()) {
+    enqueue(std::move(msg));
+    return;
+  }
+
+  // Follow the message with what its module's limit held back.
+  const LogLevel level = msg.level;
+  const ModuleId module = msg.module.id();
+  enqueue(std::move(msg));
+  if (const std::uint64_t n = lim->suppressed.take(steady_now_ns())) {
+    enqueue(LogMessage{level, module,
+                       "suppressed " + std::to_string(n) + " similar messages"});
+  }
+}
+
+void Logger::enqueue(LogMessage&& msg) {
+  if (mode_ == QueueMode::PerThread) {
+    ProducerSlot& slot = producer_slot();
+    enqueue(slot.queue, slot.drops, std::move(msg));
+    return;
+  }
+  enqueue(queue_, drops_, std::move(msg));
+}
+
+// Every policy starts with a plain push; the policies only differ once
+// the queue is full (LevelAware also reads the queue's fill level).
+void Logger::enqueue(Queue& q, DropCounters& drops, LogMessage&& msg) {
+  switch (overflow_) {
+    case OverflowPolicy::DropOldest:
+      q.push_drop_oldest(std::move(msg), [&](const LogMessage& evicted) {
+        drops.add(evicted.level);
+      });
+      return;
+    case OverflowPolicy::DropNewest:
+      if (!q.push_if_space(msg)) drops.add(msg.level);
+      return;
+    case OverflowPolicy::Block:
+      if (!q.push_wait(msg, block_timeout_)) drops.add(msg.level);
+      return;
+    case OverflowPolicy::LevelAware: {
+      if (msg.level >= LogLevel::WARN) {
+        // The headroom below normally leaves room; if a stalled sink has
+        // used it up too, wait like Block rather than hang the caller.
+        if (!q.push_wait(msg, block_timeout_)) drops.add(msg.level);
+        return;
+      }
+      // Keep headroom for WARN+: INFO may fill 7/8, TRACE/DEBUG half.
+      const std::size_t cap = q.capacity();
+      const std::size_t limit = std::max<std::size_t>(
+          1, msg.level == LogLevel::INFO ? cap - cap / 8 : cap / 2);
+      if (q.size() >= limit || !q.push_if_space(msg)) drops.add(msg.level);
+      return;
+    }
+  }
+}
+
+// One virtual call per sink per batch instead of per message. Deferred
+// messages are formatted here, on the worker, before any sink sees them.
+// Under DispatchMode::PerSink the batch is copied into each sink's queue
+// instead (moved into the last one) and written by the sink's thread.
+void Logger::dispatch(std::vector<LogMessage>& batch) {
+  if (batch.empty()) return;
+  for (auto& msg : batch) {
+    if (msg.deferred()) format_deferred(msg, format_scratch_);
+    count_module(msg);
+  }
+
+  batch_size_.record(batch.size());
+  sample_latency<kLatencySampleEvery>(enqueue_to_sink_ns_, latency_sample_,
+                                      batch.data(), batch.size());
+
+  if (dispatch_ == DispatchMode::PerSink) {
+    for (std::size_t i = 0; i < sinks_.size(); ++i) {
+      SinkSlot& s = *sinks_[i];
+      const bool last = i + 1 == sinks_.size();
+      for (auto& msg : batch) {
+        s.queue->push_drop_oldest(last ? std::move(msg) : LogMessage(msg),
+                                  [&](const LogMessage& evicted) {
+                                    s.drops.add(evicted.level);
+                                  });
+      }
+    }
+    processed_total_.fetch_add(batch.size(), std::memory_order_relaxed);
+    return;
+  }
+
+  for (auto& s : sinks_) deliver(*s, batch.data(), batch.size());
+  processed_total_.fetch_add(batch.size(), std::memory_order_relaxed);
+  flush_.mark();
+}
+
+void Logger::count_module(const LogMessage& msg) {
+  // Single writer: plain load + store, no read-modify-write.
+  const ModuleId id = msg.module.id() < ModuleRegistry::kMaxModules
+                          ? msg.module.id()
+                          : ModuleRegistry::kUnknown;
+  module_msgs_[id].store(module_msgs_[id].load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  module_bytes_[id].store(
+      module_bytes_[id].load(std::memory_order_relaxed) + msg.text.size(),
+      std::memory_order_relaxed);
+}
+
+// Runs on the logging thread. Taking dispatch_mutex_ parks the worker
+// between batches; everything queued before msg is dispatched first, then
+// msg goes to each sink directly (after that sink's own queue under
+// PerSink) and the sink is synced.
+void Logger::write_through(LogMessage msg) {
+  std::scoped_lock lk(dispatch_mutex_);
+  drain_queues_locked();
+  if (msg.deferred()) format_deferred(msg, format_scratch_);
+  count_module(msg);
+
+  std::vector<LogMessage> pending;
+  for (auto& sp : sinks_) {
+    SinkSlot& s = *sp;
+    std::scoped_lock wl(s.write_mutex);
+    if (s.queue) {
+      for (std::size_t left = s.queue->size(); left > 0;) {
+        pending.clear();
+        const std::size_t n =
+            s.queue->try_pop_batch(pending, std::min(left, batch_max_));
+        if (n == 0) break;
+        deliver(s, pending.data(), n);
+        left -= n;
+      }
+    }
+    write_to_sink(s, &msg, 1);  // never coalesced
+    s.sink->sync();
+  }
+  processed_total_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Takes only what is queued on entry, so busy producers cannot keep the
+// emergency path spinning.
+void Logger::drain_queues_locked() {
+  std::vector<LogMessage> batch;
+  if (mode_ == QueueMode::Shared) {
+    for (std::size_t left = queue_.size(); left > 0;) {
+      batch.clear();
+      const std::size_t n =
+          queue_.try_pop_batch(batch, std::min(left, batch_max_));
+      if (n == 0) break;
+      dispatch(batch);
+      left -= n;
+    }
+    return;
+  }
+
+  std::vector<std::shared_ptr<ProducerSlot>> slots;
+  {
+    std::scoped_lock lk(producers_mutex_);
+    slots = producers_;
+  }
+  std::vector<LogMessage> all;
+  for (const auto& p : slots) p->queue.try_pop_batch(all, p->queue.size());
+  std::stable_sort(all.begin(), all.end(),
+                   [](const LogMessage& a, const LogMessage& b) {
+                     return a.ts < b.ts;
+                   });
+  for (std::size_t i = 0; i < all.size(); i += batch_max_) {
+    const std::size_t end = std::min(all.size(), i + batch_max_);
+    batch.assign(std::make_move_iterator(all.begin() + i),
+                 std::make_move_iterator(all.begin() + end));
+    dispatch(batch);
+  }
+}
+
+void Logger::write_to_sink(SinkSlot& s, const LogMessage* msgs,
+                           std::size_t count) {
+  const auto t0 = std::chrono::steady_clock::now();
+  s.sink->write_batch(msgs, count);
+  s.write_ns.record(elapsed_ns(t0));
+  s.written.fetch_add(count, std::memory_order_relaxed);
+}
+
+void Logger::deliver(SinkSlot& s, const LogMessage* msgs, std::size_t count) {
+  if (!s.coalescer) {
+    write_to_sink(s, msgs, count);
     return;
   }
+  s.coalesce_out.clear();
+  s.coalescer->process(msgs, count, s.coalesce_out);
+  if (!s.coalesce_out.empty()) {
+    write_to_sink(s, s.coalesce_out.data(), s.coalesce_out.size());
+  }
+}
 
-  bool dropped = queue_.push_drop_oldest(std::move(msg));
-  if (dropped) {
-    dropped_total_.fetch_add(1, std::memory_order_relaxed);
+bool Logger::deliver_due(SinkSlot& s, bool all) {
+  if (!s.coalescer) return false;
+  s.coalesce_out.clear();
+  if (all) {
+    s.coalescer->expire_all(s.coalesce_out);
+  } else {
+    s.coalescer->expire(LogMessage::clock::now(), s.coalesce_out);
   }
+  if (s.coalesce_out.empty()) return false;
+  write_to_sink(s, s.coalesce_out.data(), s.coalesce_out.size());
+  return true;
+}
+
+void Logger::deliver_due_locked() {
+  if (dispatch_ != DispatchMode::Inline) return;
+  for (auto& s : sinks_) {
+    if (deliver_due(*s, false)) flush_.mark();
+  }
+}
+
+// DispatchMode::PerSink: drains one sink's queue and keeps its periodic
+// flush, independently of the worker and the other sinks.
+void Logger::sink_worker(SinkSlot& s) {
+  t_writer = this;
+  std::vector<LogMessage> batch;
+  batch.reserve(batch_max_);
+  auto idle = std::chrono::microseconds::zero();
+  for (;;) {
+    batch.clear();
+    // false => stop requested and queue empty; empty => timer
+    if (!s.queue->pop_wait_batch(batch, batch_max_,
+                                 std::chrono::microseconds::zero(), idle)) {
+      break;
+    }
+    std::scoped_lock lk(s.write_mutex);
+    if (!batch.empty()) {
+      sample_latency<kLatencySampleEvery>(s.enqueue_to_sink_ns,
+                                          s.latency_sample, batch.data(),
+                                          batch.size());
+      deliver(s, batch.data(), batch.size());
+      s.flush.mark();
+    }
+    if (deliver_due(s, false)) s.flush.mark();
+    if (flush_due(s.flush)) s.sink->flush();
+    idle = idle_wait(s.flush, &s);
+  }
+}
+
+// How long a writer may sleep while idle: forever unless its sinks hold
+// unflushed output, then until that output is due.
+std::chrono::microseconds Logger::flush_wait(const FlushState& st) const {
+  using namespace std::chrono;
+  if (!st.pending || flush_interval_.count() == 0) return microseconds::zero();
+  const auto left =
+      duration_cast<microseconds>(st.since + flush_interval_ - steady_clock::now());
+  return std::max(left, microseconds(1));
+}
+
+std::chrono::microseconds Logger::idle_wait(const FlushState& st,
+                                            const SinkSlot* s) const {
+  using namespace std::chrono;
+  auto wait = flush_wait(st);
+  auto sooner = [&](const SinkSlot& slot) {
+    if (!slot.coalescer) return;
+    const auto due = slot.coalescer->next_due();
+    if (!due) return;
+    const auto left = std::max(
+        duration_cast<microseconds>(*due - LogMessage::clock::now()),
+        microseconds(1));
+    if (wait.count() == 0 || left < wait) wait = left;
+  };
+  if (s != nullptr) {
+    sooner(*s);
+  } else if (dispatch_ == DispatchMode::Inline) {
+    for (const auto& slot : sinks_) sooner(*slot);
+  }
+  return wait;
+}
+
+bool Logger::flush_due(FlushState& st) const {
+  if (!st.pending || flush_interval_.count() == 0) return false;
+  if (std::chrono::steady_clock::now() - st.since < flush_interval_) {
+    return false;
+  }
+  st.pending = false;
+  return true;
+}
+
+void Logger::flush_if_due() {
+  if (!flush_due(flush_)) return;
+  for (auto& s : sinks_) s->sink->flush();
 }
 
 void Logger::worker() {
-  LogMessage msg{LogLevel::INFO, "_bootstrap", ""};
-  while (running_.load(std::memory_order_relaxed)) {
-    if (!queue_.pop_wait(msg)) break;  // stop requested and queue empty
+  t_writer = this;
+  if (mode_ == QueueMode::PerThread) {
+    worker_per_thread();
+    return;
+  }
+
+  std::vector<LogMessage> batch;
+  batch.reserve(batch_max_);
+  auto idle = std::chrono::microseconds::zero();
+  // Exit only through the queue, so a stop that comes before the first pop
+  // still drains what was logged.
+  for (;;) {
+    batch.clear();
+    // false => stop requested and queue empty
+    if (!queue_.pop_wait_batch(batch, batch_max_, batch_linger_, idle)) {
+      break;
+    }
+    std::scoped_lock lk(dispatch_mutex_);
+    dispatch(batch);
+    deliver_due_locked();
+    flush_if_due();
+    idle = idle_wait(flush_, nullptr);
+  }
+}
+
+// Merges the per-thread queues: each queue is FIFO, so holding one staged
+// message per queue and always emitting the oldest staged one keeps the
+// output ordered by LogMessage::ts.
+void Logger::worker_per_thread() {
+  struct Source {
+    std::shared_ptr<ProducerSlot> slot;
+    std::optional<LogMessage> staged;
+  };
+  std::vector<Source> sources;
+  std::uint64_t seen_version = ~std::uint64_t{0};
+  LogMessage tmp{LogLevel::INFO, "_bootstrap", ""};
+  std::vector<LogMessage> batch;
+  batch.reserve(batch_max_);
+
+  auto refresh_sources = [&] {
+    const std::uint64_t v = producers_version_.load(std::memory_order_acquire);
+    if (v == seen_version) return;
+    seen_version = v;
+    std::scoped_lock lk(producers_mutex_);
+    for (const auto& p : producers_) {
+      const bool known =
+          std::any_of(sources.begin(), sources.end(),
+                      [&](const Source& s) { return s.slot == p; });
+      if (!known) sources.push_back(Source{p, std::nullopt});
+    }
+  };
+
+  // Drops slots whose thread exited once everything they held is written.
+  auto reap_orphans = [&] {
+    for (auto it = sources.begin(); it != sources.end();) {
+      ProducerSlot& s = *it->slot;
+      if (!it->staged && s.orphaned.load(std::memory_order_acquire) &&
+          s.queue.empty()) {
+        std::scoped_lock lk(producers_mutex_);
+        for (std::size_t i = 0; i < kLevelCount; ++i) {
+          retired_dropped_[i] += s.drops.by_level[i].load(std::memory_order_relaxed);
+        }
+        retired_peak_ = std::max(retired_peak_, s.queue.peak());
+        producers_.erase(
+            std::remove(producers_.begin(), producers_.end(), it->slot),
+            producers_.end());
+        it = sources.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  };
+
+  // Moves the oldest staged message into the batch; false if all are empty.
+  auto take_oldest = [&] {
+    Source* oldest = nullptr;
+    for (auto& src : sources) {
+      if (!src.staged && src.slot->queue.try_pop(tmp)) {
+        src.staged.emplace(std::move(tmp));
+      }
+      if (src.staged &&
+          (oldest == nullptr || src.staged->ts < oldest->staged->ts)) {
+        oldest = &src;
+      }
+    }
+    if (oldest == nullptr) return false;
+    batch.push_back(std::move(*oldest->staged));
+    oldest->staged.reset();
+    return true;
+  };
+
+  auto work_ready = [&] {
+    if (!running_.load(std::memory_order_relaxed)) return true;
+    if (producers_version_.load(std::memory_order_acquire) != seen_version) {
+      return true;
+    }
+    return std::any_of(sources.begin(), sources.end(), [](const Source& s) {
+      return !s.slot->queue.empty();
+    });
+  };
+
+  for (;;) {
+    const bool stopping = !running_.load(std::memory_order_relaxed);
+    refresh_sources();
+
+    batch.clear();
+    while (batch.size() < batch_max_ && take_oldest()) {
+    }
 
-    for (auto& s : sinks_) {
-      s->write(msg);
+    if (!batch.empty() && batch.size() < batch_max_ &&
+        batch_linger_.count() > 0 && !stopping) {
+      const auto deadline = std::chrono::steady_clock::now() + batch_linger_;
+      while (batch.size() < batch_max_ &&
+             running_.load(std::memory_order_relaxed) &&
+             bell_.wait_until(work_ready, deadline)) {
+        refresh_sources();
+        while (batch.size() < batch_max_ && take_oldest()) {
+        }
+      }
+    }
+
+    if (!batch.empty()) {
+      std::scoped_lock lk(dispatch_mutex_);
+      dispatch(batch);
+      deliver_due_locked();
+      flush_if_due();
+      continue;
+    }
+
+    reap_orphans();
+    if (stopping) break;  // stop requested and every queue drained
+
+    std::chrono::microseconds idle;
+    {
+      std::scoped_lock lk(dispatch_mutex_);
+      deliver_due_locked();
+      flush_if_due();
+      idle = idle_wait(flush_, nullptr);
+    }
+    if (idle.count() > 0) {
+      bell_.wait_until(work_ready, std::chrono::steady_clock::now() + idle);
+    } else {
+      bell_.wait(work_ready);
     }
-    processed_total_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
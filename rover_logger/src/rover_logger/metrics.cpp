@@ -0,0 +1,171 @@
+#include "rover_logger/metrics.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+#include "rover_logger/json_formatter.hpp"
+
+namespace rover_logger {
+
+Histogram::Histogram() {
+  for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+}
+
+// Values below kSubBuckets get one bucket each; above that, the top
+// kSubBits bits after the leading one pick the sub-bucket.
+std::size_t Histogram::bucket_index(std::uint64_t value) {
+  if (value < kSubBuckets) return static_cast<std::size_t>(value);
+  const int msb = 63 - __builtin_clzll(value);
+  const auto sub = static_cast<std::size_t>(value >> (msb - kSubBits)) &
+                   (kSubBuckets - 1);
+  return static_cast<std::size_t>(msb - kSubBits + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t Histogram::bucket_upper(std::size_t idx) {
+  if (idx < kSubBuckets) return idx;
+  const int msb = static_cast<int>(idx / kSubBuckets) + kSubBits - 1;
+  const std::uint64_t sub = idx % kSubBuckets;
+  const int shift = msb - kSubBits;
+  const std::uint64_t lower = (kSubBuckets + sub) << shift;
+  return lower + ((std::uint64_t{1} << shift) - 1);
+}
+
+void Histogram::record(std::uint64_t value) {
+  buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  std::uint64_t m = max_.load(std::memory_order_relaxed);
+  while (value > m &&
+         !max_.compare_exchange_weak(m, value, std::memory_order_relaxed)) {
+  }
+}
+
+HistogramSummary Histogram::summary() const {
+  HistogramSummary s;
+  std::uint64_t counts[kBuckets];
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  s.count = total;
+  if (total == 0) return s;
+  s.max = max_.load(std::memory_order_relaxed);
+  s.mean = static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+           static_cast<double>(count_.load(std::memory_order_relaxed));
+
+  struct Target {
+    double q;
+    std::uint64_t* out;
+  };
+  const Target targets[] = {
+      {0.50, &s.p50}, {0.90, &s.p90}, {0.99, &s.p99}, {0.999, &s.p999}};
+  std::size_t t = 0;
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBuckets && t < 4; ++i) {
+    seen += counts[i];
+    while (t < 4 && static_cast<double>(seen) >=
+                        targets[t].q * static_cast<double>(total)) {
+      *targets[t].out = std::min(bucket_upper(i), s.max);
+      ++t;
+    }
+  }
+  return s;
+}
+
+namespace {
+
+// Counters print exactly; %g would turn large ones into 1.234567890e+12.
+void append_num(std::string& out, const char* key, std::uint64_t v,
+                bool comma = true) {
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "\"%s\":%" PRIu64 "%s", key, v,
+                comma ? "," : "");
+  out += buf;
+}
+
+// Means and rates.
+void append_num(std::string& out, const char* key, double v, bool comma = true) {
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "\"%s\":%.10g%s", key, v, comma ? "," : "");
+  out += buf;
+}
+
+void append_summary(std::string& out, const char* key,
+                    const HistogramSummary& s) {
+  out += '"';
+  out += key;
+  out += "\":{";
+  append_num(out, "count", s.count);
+  append_num(out, "mean", s.mean);
+  append_num(out, "p50", s.p50);
+  append_num(out, "p90", s.p90);
+  append_num(out, "p99", s.p99);
+  append_num(out, "p999", s.p999);
+  append_num(out, "max", s.max, false);
+  out += '}';
+}
+
+}  // namespace
+
+std::string metrics_to_json(const LoggerMetrics& m) {
+  using namespace std::chrono;
+  std::string out = "{";
+  append_num(out, "ts_ms",
+             static_cast<std::uint64_t>(
+                 duration_cast<milliseconds>(m.taken.time_since_epoch()).count()));
+  append_num(out, "interval_sec", m.interval_sec);
+  append_num(out, "processed_total", m.processed_total);
+  append_num(out, "dropped_total", m.dropped_total);
+  out += "\"dropped_by_level\":{";
+  for (std::size_t i = 0; i < kLevelCount; ++i) {
+    const std::string key(to_string(static_cast<LogLevel>(i)));
+    append_num(out, key.c_str(), m.dropped_by_level[i], i + 1 < kLevelCount);
+  }
+  out += "},";
+  append_num(out, "suppressed_total", m.suppressed_total);
+  append_num(out, "queue_depth", static_cast<std::uint64_t>(m.queue_depth));
+  append_num(out, "queue_capacity",
+             static_cast<std::uint64_t>(m.queue_capacity));
+  append_num(out, "queue_peak", static_cast<std::uint64_t>(m.queue_peak));
+  append_summary(out, "enqueue_to_sink_ns", m.enqueue_to_sink_ns);
+  out += ',';
+  append_summary(out, "batch_size", m.batch_size);
+
+  out += ",\"sinks\":[";
+  for (std::size_t i = 0; i < m.sinks.size(); ++i) {
+    if (i) out += ',';
+    out += "{\"name\":\"";
+    append_json_escaped(out, m.sinks[i].name);
+    out += "\",";
+    const SinkMetrics& sm = m.sinks[i];
+    append_num(out, "written", sm.written);
+    append_num(out, "coalesced", sm.coalesced);
+    append_num(out, "dropped", sm.dropped);
+    append_num(out, "queue_depth", static_cast<std::uint64_t>(sm.queue_depth));
+    append_num(out, "queue_peak", static_cast<std::uint64_t>(sm.queue_peak));
+    append_summary(out, "write_ns", sm.write_ns);
+    out += ',';
+    append_summary(out, "enqueue_to_sink_ns", sm.enqueue_to_sink_ns);
+    out += '}';
+  }
+
+  out += "],\"modules\":[";
+  for (std::size_t i = 0; i < m.modules.size(); ++i) {
+    const ModuleMetrics& mod = m.modules[i];
+    if (i) out += ',';
+    out += "{\"module\":\"";
+    append_json_escaped(out, mod.module);
+    out += "\",";
+    append_num(out, "messages", mod.messages);
+    append_num(out, "bytes", mod.bytes);
+    append_num(out, "messages_per_sec", mod.messages_per_sec);
+    append_num(out, "bytes_per_sec", mod.bytes_per_sec, false);
+    out += '}';
+  }
+  out += "]}";
+  return out;
+}
+
+}  // namespace rover_logger
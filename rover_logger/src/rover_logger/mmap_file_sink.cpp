@@ -0,0 +1,225 @@
+#include "rover_logger/mmap_file_sink.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace rover_logger {
+
+MmapFileSink::MmapFileSink(MmapFileSinkOptions opt)
+    : opt_(std::move(opt)), ts_(opt_.timestamp) {
+  if (auto seg = map_segment(0)) {
+    active_ = *seg;
+    next_index_ = 1;
+    next_requested_ = true;
+  } else {
+    note_prepare_failure();
+  }
+  thread_ = std::thread(&MmapFileSink::run, this);
+}
+
+MmapFileSink::~MmapFileSink() {
+  {
+    std::scoped_lock lk(m_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+
+  // The helper has drained retiring_; finish the live segment here and
+  // drop a prepared one that was never written.
+  retire(active_);
+  if (next_) {
+    retire(*next_);
+    std::remove(file_name(next_->index).c_str());
+  }
+}
+
+std::string MmapFileSink::file_name(int index) const {
+  return opt_.base_filename + "_" + std::to_string(index) + ".log";
+}
+
+std::optional<MmapFileSink::Segment> MmapFileSink::map_segment(
+    int index) const {
+  Segment seg;
+  seg.index = index;
+  seg.size = std::max<std::size_t>(opt_.segment_bytes, 1);
+  seg.fd = ::open(file_name(index).c_str(),
+                  O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (seg.fd < 0) return std::nullopt;
+
+  // A sparse file is only acceptable where the filesystem cannot
+  // preallocate at all. On ENOSPC and the like the pages would have no
+  // blocks behind them, and the first store past the end of free space
+  // raises SIGBUS instead of failing a write.
+  const auto len = static_cast<off_t>(seg.size);
+  const int err = ::posix_fallocate(seg.fd, 0, len);
+  const bool sparse_ok = err == EOPNOTSUPP || err == EINVAL;
+  if (err != 0 && !(sparse_ok && ::ftruncate(seg.fd, len) == 0)) {
+    ::close(seg.fd);
+    std::remove(file_name(index).c_str());
+    return std::nullopt;
+  }
+  void* p = ::mmap(nullptr, seg.size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   seg.fd, 0);
+  if (p == MAP_FAILED) {
+    ::close(seg.fd);
+    std::remove(file_name(index).c_str());
+    return std::nullopt;
+  }
+  ::madvise(p, seg.size, MADV_SEQUENTIAL);
+  seg.base = static_cast<char*>(p);
+  return seg;
+}
+
+// Writes back, trims the preallocated tail and releases the segment.
+void MmapFileSink::retire(Segment& seg) {
+  if (seg.base != nullptr) {
+    ::msync(seg.base, seg.size, MS_SYNC);
+    ::munmap(seg.base, seg.size);
+    seg.base = nullptr;
+  }
+  if (seg.fd >= 0) {
+    if (::ftruncate(seg.fd, static_cast<off_t>(seg.used)) != 0) {
+      // Keeping the NUL padding is the only option left.
+    }
+    ::close(seg.fd);
+    seg.fd = -1;
+  }
+}
+
+// Called with m_ held (or before the helper starts).
+void MmapFileSink::note_prepare_failure() {
+  prepare_failed_ = true;
+  retry_at_ = std::chrono::steady_clock::now() + opt_.retry_interval;
+  prepare_failures_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MmapFileSink::rotate() {
+  Segment next;
+  {
+    std::unique_lock lk(m_);
+    if (!next_ && prepare_failed_) {
+      // Don't wait on a failing disk: the caller drops the line, and the
+      // helper gets another try once retry_interval has passed.
+      if (!next_requested_ &&
+          std::chrono::steady_clock::now() >= retry_at_) {
+        next_requested_ = true;
+        cv_.notify_one();
+      }
+      return;
+    }
+    // Normally already mapped; only waits if segments fill faster than
+    // the helper can preallocate them.
+    ready_cv_.wait(lk, [&] { return next_.has_value() || !next_requested_; });
+    if (!next_) return;  // that attempt failed
+    next = *next_;
+    next_.reset();
+    retiring_.push_back(active_);
+    next_index_ = next.index + 1;
+    next_requested_ = true;
+  }
+  cv_.notify_one();
+  active_ = next;
+}
+
+void MmapFileSink::append(const char* data, std::size_t len) {
+  // With no segment mapped (preallocation failed) each line checks for
+  // one, without blocking.
+  if (active_.base == nullptr ||
+      (active_.used > 0 && active_.used + len > active_.size)) {
+    rotate();
+  }
+  if (active_.base == nullptr ||
+      (active_.used > 0 && active_.used + len > active_.size)) {
+    dropped_bytes_.fetch_add(len, std::memory_order_relaxed);
+    return;
+  }
+  if (len > active_.size) {
+    dropped_bytes_.fetch_add(len - active_.size, std::memory_order_relaxed);
+    len = active_.size;
+  }
+  std::memcpy(active_.base + active_.used, data, len);
+  active_.used += len;
+}
+
+void MmapFileSink::write(const LogMessage& msg) {
+  std::scoped_lock lk(write_m_);
+  line_buf_.clear();
+  append_json_line(line_buf_, msg, ts_);
+  line_buf_.push_back('\n');
+  append(line_buf_.data(), line_buf_.size());
+}
+
+// Lines are copied one by one so that each stays whole within a segment.
+void MmapFileSink::write_batch(const LogMessage* msgs, std::size_t count) {
+  std::scoped_lock lk(write_m_);
+  for (std::size_t i = 0; i < count; ++i) {
+    line_buf_.clear();
+    append_json_line(line_buf_, msgs[i], ts_);
+    line_buf_.push_back('\n');
+    append(line_buf_.data(), line_buf_.size());
+  }
+}
+
+void MmapFileSink::flush() {
+  std::scoped_lock lk(write_m_);
+  if (active_.base == nullptr || active_.used == active_.synced) return;
+  // msync needs a page-aligned start.
+  const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  const std::size_t from = active_.synced / page * page;
+  ::msync(active_.base + from, active_.used - from, MS_ASYNC);
+  active_.synced = active_.used;
+}
+
+void MmapFileSink::sync() {
+  std::scoped_lock lk(write_m_);
+  if (active_.base == nullptr || active_.used == 0) return;
+  // Also covers pages flush() only scheduled with MS_ASYNC.
+  ::msync(active_.base, active_.used, MS_SYNC);
+  active_.synced = active_.used;
+}
+
+void MmapFileSink::run() {
+  std::unique_lock lk(m_);
+  for (;;) {
+    cv_.wait(lk, [&] { return stop_ || next_requested_ || !retiring_.empty(); });
+
+    if (next_requested_ && !next_ && !stop_) {
+      const int index = next_index_;
+      lk.unlock();
+      auto seg = map_segment(index);
+      lk.lock();
+      next_ = std::move(seg);
+      if (next_) {
+        prepare_failed_ = false;
+      } else {
+        note_prepare_failure();
+      }
+      next_requested_ = false;
+      ready_cv_.notify_all();
+    }
+
+    while (!retiring_.empty()) {
+      Segment seg = retiring_.front();
+      retiring_.pop_front();
+      lk.unlock();
+      retire(seg);
+      lk.lock();
+    }
+
+    if (stop_) {
+      next_requested_ = false;
+      ready_cv_.notify_all();
+      break;
+    }
+  }
+}
+
+}  // namespace rover_logger
@@ -0,0 +1,73 @@
+#include "rover_logger/module_registry.hpp"
+
+namespace rover_logger {
+
+namespace {
+// FNV-1a: module names are short, so a simple byte hash is plenty.
+std::size_t hash_name(std::string_view s) {
+  std::uint64_t h = 14695981039346656037ull;
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return static_cast<std::size_t>(h);
+}
+}  // namespace
+
+// Intentionally leaked so names stay valid during static destruction.
+ModuleRegistry& ModuleRegistry::instance() {
+  static ModuleRegistry* registry = new ModuleRegistry;
+  return *registry;
+}
+
+ModuleRegistry::ModuleRegistry() {
+  for (auto& s : slots_) s.store(0, std::memory_order_relaxed);
+  for (auto& n : names_) n.store(nullptr, std::memory_order_relaxed);
+
+  storage_.emplace_back("?");
+  names_[kUnknown].store(&storage_.back(), std::memory_order_release);
+  count_.store(1, std::memory_order_release);
+}
+
+ModuleId ModuleRegistry::intern(std::string_view name) {
+  // Fast path: already interned.
+  if (const ModuleId id = find(name); id != kUnknown) return id;
+
+  // Slow path: re-probe under the lock (another thread may have won).
+  const std::size_t mask = kSlots - 1;
+  std::scoped_lock lk(insert_mutex_);
+  std::size_t i = hash_name(name) & mask;
+  for (;; i = (i + 1) & mask) {
+    const ModuleId id = slots_[i].load(std::memory_order_relaxed);
+    if (id == 0) break;
+    if (*names_[id].load(std::memory_order_relaxed) == name) return id;
+  }
+
+  const std::size_t n = count_.load(std::memory_order_relaxed);
+  if (n >= kMaxModules) return kUnknown;
+
+  storage_.emplace_back(name);
+  const auto id = static_cast<ModuleId>(n);
+  names_[id].store(&storage_.back(), std::memory_order_release);
+  count_.store(n + 1, std::memory_order_release);
+  slots_[i].store(id, std::memory_order_release);
+  return id;
+}
+
+ModuleId ModuleRegistry::find(std::string_view name) const {
+  const std::size_t mask = kSlots - 1;
+  for (std::size_t i = hash_name(name) & mask;; i = (i + 1) & mask) {
+    const ModuleId id = slots_[i].load(std::memory_order_acquire);
+    if (id == 0) return kUnknown;
+    if (*names_[id].load(std::memory_order_relaxed) == name) return id;
+  }
+}
+
+std::string_view ModuleRegistry::name(ModuleId id) const {
+  if (id >= kMaxModules) id = kUnknown;
+  const std::string* s = names_[id].load(std::memory_order_acquire);
+  if (s == nullptr) s = names_[kUnknown].load(std::memory_order_acquire);
+  return *s;
+}
+
+}  // namespace rover_logger
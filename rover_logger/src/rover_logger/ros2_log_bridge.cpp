@@ -1,22 +1,25 @@
 #include "rover_logger/ros2_log_bridge.hpp"
 
+#include <chrono>
+#include <functional>
+
 namespace rover_logger {
 
 Ros2LogBridge::Ros2LogBridge(const LoggerConfig& cfg,
                              const std::string& config_path,
                              const rclcpp::NodeOptions& options)
     : rclcpp::Node("rover_logger_bridge", options),
-      logger_((cfg.max_queue == 0) ? static_cast<std::size_t>(2048)
-                                   : cfg.max_queue) {
+      logger_(cfg) {
   // Attach sinks (terminal + rotating files).
   sinks_ = make_all_sinks(cfg);
-  for (auto& s : sinks_) {
-    logger_.add_sink(s);
+  for (std::size_t i = 0; i < sinks_.size(); ++i) {
+    logger_.add_sink(sinks_[i], coalesce_config(cfg.sinks[i]));
   }
 
-  // Apply filter config: global + per-module.
+  // Apply filter config: global + per-module levels and limits.
   logger_.set_min_level(cfg.level);
   logger_.apply_module_config(cfg.modules);
+  logger_.apply_module_limits(cfg.module_limits);
 
   // Subscribe to /rover/log from all rover subsystems.
   sub_ = this->create_subscription<rover_msgs::msg::LogEntry>(
@@ -24,6 +27,14 @@ Ros2LogBridge::Ros2LogBridge(const LoggerConfig& cfg,
       rclcpp::QoS(100).best_effort(),
       std::bind(&Ros2LogBridge::handle_log_msg, this, std::placeholders::_1));
 
+  if (cfg.metrics_interval_ms > 0) {
+    metrics_pub_ = this->create_publisher<std_msgs::msg::String>(
+        "/rover/logger/metrics", rclcpp::QoS(10));
+    metrics_timer_ = this->create_wall_timer(
+        std::chrono::milliseconds(cfg.metrics_interval_ms),
+        std::bind(&Ros2LogBridge::publish_metrics, this));
+  }
+
   RCLCPP_INFO(this->get_logger(),
               "Rover logger bridge initialised with config '%s'",
               config_path.c_str());
@@ -43,4 +54,10 @@ void Ros2LogBridge::handle_log_msg(
   logger_.log(std::move(lm));
 }
 
+void Ros2LogBridge::publish_metrics() {
+  std_msgs::msg::String out;
+  out.data = metrics_to_json(logger_.metrics_snapshot());
+  metrics_pub_->publish(std::move(out));
+}
+
 }  // namespace rover_logger
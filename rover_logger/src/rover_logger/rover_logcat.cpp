@@ -0,0 +1,129 @@
+// rover_logcat: decode binary log files (format: binary) back to text or
+// JSON lines.
+//
+//   rover_logcat [--json] [--ts iso8601_ms|...|epoch_ns] [file... | -]
+//
+// Reads stdin when no file (or "-") is given, so gzip'd rotations can be
+// piped in: zcat rover_log_*.log.gz | rover_logcat --json
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "rover_logger/binary_format.hpp"
+#include "rover_logger/config.hpp"
+#include "rover_logger/json_formatter.hpp"
+
+using namespace rover_logger;
+
+namespace {
+
+struct Options {
+  bool json = false;
+  TimestampFormat ts = TimestampFormat::Iso8601Millis;
+};
+
+void usage() {
+  std::cerr << "usage: rover_logcat [--json] [--ts FORMAT] [file... | -]\n";
+}
+
+// Prints every record of one stream; false on a corrupt file.
+bool dump_records(std::istream& in, const std::string& name, const Options& opt,
+                  TimestampFormatter& ts, std::string& line) {
+  BinaryLogDecoder dec(in);
+  DecodedRecord rec;
+  for (;;) {
+    const auto st = dec.next(rec);
+    if (st == BinaryLogDecoder::Status::End) return true;
+    if (st == BinaryLogDecoder::Status::Corrupt) {
+      std::cout.flush();
+      std::cerr << "rover_logcat: " << name << ": " << dec.error() << "\n";
+      return false;
+    }
+
+    LogMessage msg(rec.level, rec.module, rec.text);
+    msg.ts = LogMessage::clock::time_point(
+        std::chrono::duration_cast<LogMessage::clock::duration>(
+            std::chrono::nanoseconds(rec.ts_ns)));
+
+    line.clear();
+    if (opt.json) {
+      append_json_line(line, msg, ts);
+    } else {
+      ts.append(line, msg.ts);
+      line.append(" [")
+          .append(to_string(rec.level))
+          .append("] (")
+          .append(rec.module)
+          .append(") ")
+          .append(rec.text);
+    }
+    line.push_back('\n');
+    std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+  }
+}
+
+// As dump_records, but an exception (e.g. out of memory on a damaged
+// file) is reported like any other error instead of aborting.
+bool dump(std::istream& in, const std::string& name, const Options& opt,
+          TimestampFormatter& ts, std::string& line) {
+  try {
+    return dump_records(in, name, opt, ts, line);
+  } catch (const std::exception& e) {
+    std::cout.flush();
+    std::cerr << "rover_logcat: " << name << ": " << e.what() << "\n";
+    return false;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--json") == 0) {
+      opt.json = true;
+    } else if (std::strcmp(argv[i], "--ts") == 0 && i + 1 < argc) {
+      try {
+        opt.ts = parse_timestamp_format(argv[++i]);
+      } catch (const std::exception& e) {
+        std::cerr << "rover_logcat: " << e.what() << "\n";
+        return 2;
+      }
+    } else if (std::strcmp(argv[i], "-h") == 0 ||
+               std::strcmp(argv[i], "--help") == 0) {
+      usage();
+      return 0;
+    } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+      usage();
+      return 2;
+    } else {
+      files.emplace_back(argv[i]);
+    }
+  }
+  if (files.empty()) files.emplace_back("-");
+
+  std::ios::sync_with_stdio(false);
+  TimestampFormatter ts(opt.ts);
+  std::string line;
+  int rc = 0;
+  for (const auto& f : files) {
+    if (f == "-") {
+      if (!dump(std::cin, "<stdin>", opt, ts, line)) rc = 1;
+      continue;
+    }
+    std::ifstream in(f, std::ios::binary);
+    if (!in) {
+      std::cerr << "rover_logcat: cannot open " << f << "\n";
+      rc = 1;
+      continue;
+    }
+    if (!dump(in, f, opt, ts, line)) rc = 1;
+  }
+  return rc;
+}
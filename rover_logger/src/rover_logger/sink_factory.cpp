@@ -3,6 +3,8 @@
 #include <memory>
 
 #include "rover_logger/file_rotation_adapter.hpp"
+#include "rover_logger/mmap_file_sink.hpp"
+#include "rover_logger/uring_file_sink.hpp"
 #include "rover_logger/terminal_sink.hpp"
 
 namespace rover_logger {
@@ -24,10 +26,50 @@ std::shared_ptr<ILogSink> make_sink(const SinkConfig& cfg) {
 
     opt.rotation_bytes = cfg.rotation_bytes.value_or(default_rotation);
     opt.format = AdaptFormat::JSON;
+    if (cfg.format) {
+      if (*cfg.format == "text") {
+        opt.format = AdaptFormat::Text;
+      } else if (*cfg.format == "binary") {
+        opt.format = AdaptFormat::Binary;
+      } else if (*cfg.format != "json") {
+        throw std::runtime_error("Unknown file format: " + *cfg.format);
+      }
+    }
+    if (cfg.timestamp) {
+      opt.timestamp = parse_timestamp_format(*cfg.timestamp);
+    }
+    opt.flush_level = cfg.flush_level.value_or(opt.flush_level);
+    opt.sync_level = cfg.sync_level.value_or(opt.sync_level);
+    opt.compress = cfg.compress.value_or(false);
+    opt.rotate_keep = cfg.rotate_keep.value_or(-1);
+    opt.compress_level = cfg.compress_level.value_or(opt.compress_level);
+    opt.compress_nice = cfg.compress_nice.value_or(opt.compress_nice);
 
     return std::make_shared<FileRotationAdapter>(opt);
   }
 
+  if (cfg.type == "mmap_file") {
+    MmapFileSinkOptions opt;
+    opt.base_filename = cfg.path.value_or("rover_log");
+    // rotation_bytes is the size of each preallocated segment.
+    opt.segment_bytes = cfg.rotation_bytes.value_or(opt.segment_bytes);
+    if (cfg.timestamp) {
+      opt.timestamp = parse_timestamp_format(*cfg.timestamp);
+    }
+    return std::make_shared<MmapFileSink>(opt);
+  }
+
+  if (cfg.type == "uring_file") {
+    UringFileSinkOptions opt;
+    opt.base_filename = cfg.path.value_or("rover_log");
+    opt.rotation_bytes = cfg.rotation_bytes.value_or(opt.rotation_bytes);
+    opt.sync_level = cfg.sync_level.value_or(opt.sync_level);
+    if (cfg.timestamp) {
+      opt.timestamp = parse_timestamp_format(*cfg.timestamp);
+    }
+    return std::make_shared<UringFileSink>(opt);
+  }
+
   if (cfg.type == "network") {
     // Placeholder – can be implemented later.
     throw std::runtime_error("Network sink not implemented in this build");
@@ -45,4 +87,11 @@ std::vector<std::shared_ptr<ILogSink>> make_all_sinks(const LoggerConfig& cfg) {
   return out;
 }
 
+CoalesceConfig coalesce_config(const SinkConfig& cfg) {
+  CoalesceConfig cc;
+  cc.window_ms = cfg.coalesce_window_ms.value_or(cc.window_ms);
+  cc.max_entries = cfg.coalesce_entries.value_or(cc.max_entries);
+  return cc;
+}
+
 }  // namespace rover_logger
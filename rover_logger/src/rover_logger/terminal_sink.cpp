@@ -1,15 +1,17 @@
 #include "rover_logger/terminal_sink.hpp"
 
+#include <unistd.h>
+
+#include <cerrno>
 #include <chrono>
+#include <cstring>
 #include <ctime>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
 
 namespace rover_logger {
 
-TerminalSink::TerminalSink(bool colorize)
-    : colorize_(colorize) {}
+TerminalSink::TerminalSink(bool colorize, int fd)
+    : fd_(fd < 0 ? STDOUT_FILENO : fd),
+      colorize_(colorize && ::isatty(fd_) == 1) {}
 
 const char* TerminalSink::color_for(LogLevel lv) {
   switch (lv) {
@@ -29,25 +31,71 @@ const char* TerminalSink::color_for(LogLevel lv) {
   }
 }
 
-std::string TerminalSink::format_ts(const LogMessage::clock::time_point& tp) {
+void TerminalSink::format_ts(std::string& out,
+                             const LogMessage::clock::time_point& tp) {
+  using namespace std::chrono;
   using clock = LogMessage::clock;
-  std::time_t t = clock::to_time_t(tp);
+  const std::time_t t = clock::to_time_t(tp);
+
+  if (t != ts_cached_sec_) {
+    std::tm tm{};
+    // Correct order: time_t* first, tm* second
+    localtime_r(&t, &tm);
+    if (std::strftime(ts_cached_, sizeof(ts_cached_), "%Y-%m-%d %H:%M:%S",
+                      &tm) == 0) {
+      std::strcpy(ts_cached_, "1970-01-01 00:00:00");
+    }
+    ts_cached_sec_ = t;
+  }
+
+  auto ms = duration_cast<milliseconds>(tp.time_since_epoch()).count() % 1000;
+  if (ms < 0) ms += 1000;
+  const char frac[4] = {'.', static_cast<char>('0' + ms / 100),
+                        static_cast<char>('0' + ms / 10 % 10),
+                        static_cast<char>('0' + ms % 10)};
+  out.append(ts_cached_).append(frac, sizeof(frac));
+}
 
-  std::tm tm{};
-  // Correct order: time_t* first, tm* second
-  localtime_r(&t, &tm);
+// "2025-01-01 12:00:00.123 [INFO] (/drive) text"
+void TerminalSink::append_line(const LogMessage& msg) {
+  format_ts(buf_, msg.ts);
+  buf_.push_back(' ');
+  if (colorize_) buf_.append(color_for(msg.level));
+  buf_.push_back('[');
+  buf_.append(to_string(msg.level));
+  buf_.push_back(']');
+  if (colorize_) buf_.append("\033[0m");
+  buf_.append(" (").append(msg.module.view()).append(") ");
+  buf_.append(msg.text.view());
+  buf_.push_back('\n');
+}
 
-  char buf[64];
-  if (std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm) == 0) {
-    return "1970-01-01 00:00:00";
+// One write(2) for the whole buffer, retrying on EINTR and short writes.
+void TerminalSink::write_out() {
+  const char* p = buf_.data();
+  std::size_t left = buf_.size();
+  while (left > 0) {
+    const ssize_t n = ::write(fd_, p, left);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      break;  // nowhere to report a broken stdout; drop the batch
+    }
+    p += n;
+    left -= static_cast<std::size_t>(n);
   }
-  return std::string(buf);
+  buf_.clear();
+}
+
+void TerminalSink::write(const LogMessage& msg) {
+  std::scoped_lock lk(m_);
+  append_line(msg);
+  write_out();
 }
 
-void TerminalSink::write(const LogMessage& /*msg*/) {
-  // TODO: implement pretty terminal output once LogMessage layout is final.
-  // For now this is a stub so the core library builds without depending
-  // on specific LogMessage fields.
+void TerminalSink::write_batch(const LogMessage* msgs, std::size_t count) {
+  std::scoped_lock lk(m_);
+  for (std::size_t i = 0; i < count; ++i) append_line(msgs[i]);
+  write_out();
 }
 
 }  // namespace rover_logger
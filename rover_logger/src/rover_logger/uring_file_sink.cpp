@@ -0,0 +1,457 @@
+#include "rover_logger/uring_file_sink.hpp"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ROVER_LOGGER_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#else
+#define ROVER_LOGGER_HAVE_IO_URING 0
+#endif
+
+namespace rover_logger {
+
+namespace {
+// user_data layout: file slot in the high half, fsync flag, buffer index.
+constexpr std::uint64_t kFsyncFlag = 1ull << 31;
+
+std::uint64_t make_user_data(int file, int buf, bool fsync) {
+  return (static_cast<std::uint64_t>(file) << 32) | (fsync ? kFsyncFlag : 0) |
+         static_cast<std::uint32_t>(buf);
+}
+}  // namespace
+
+#if ROVER_LOGGER_HAVE_IO_URING
+
+// Minimal io_uring wrapper over the raw syscalls (no liburing dependency):
+// one submission ring, one completion ring, optionally registered buffers.
+// Only used from the sink's thread (under its mutex).
+class UringFileSink::Ring {
+ public:
+  static std::unique_ptr<Ring> create(unsigned entries,
+                                      const std::vector<iovec>& iovs) {
+    auto r = std::unique_ptr<Ring>(new Ring);
+    io_uring_params p{};
+    r->fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+    if (r->fd_ < 0) return nullptr;
+
+    r->sq_len_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    r->single_mmap_ = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (r->single_mmap_) r->sq_len_ = r->cq_len_ = std::max(r->sq_len_, r->cq_len_);
+
+    r->sq_ptr_ = ::mmap(nullptr, r->sq_len_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, r->fd_, IORING_OFF_SQ_RING);
+    if (r->sq_ptr_ == MAP_FAILED) return nullptr;
+    r->cq_ptr_ = r->single_mmap_
+                     ? r->sq_ptr_
+                     : ::mmap(nullptr, r->cq_len_, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, r->fd_,
+                              IORING_OFF_CQ_RING);
+    if (r->cq_ptr_ == MAP_FAILED) return nullptr;
+    r->sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, r->sqes_len_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, r->fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return nullptr;
+    r->sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<char*>(r->sq_ptr_);
+    r->sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    r->sq_mask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    r->sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    r->sq_entries_ = p.sq_entries;
+    auto* cq = static_cast<char*>(r->cq_ptr_);
+    r->cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    r->cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    r->cq_mask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    r->cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+    // Registered buffers save the per-write page pinning; optional, since
+    // RLIMIT_MEMLOCK may not allow it.
+    r->fixed_ = ::syscall(__NR_io_uring_register, r->fd_,
+                          IORING_REGISTER_BUFFERS, iovs.data(),
+                          static_cast<unsigned>(iovs.size())) == 0;
+    return r;
+  }
+
+  ~Ring() {
+    if (sqes_ != nullptr) ::munmap(sqes_, sqes_len_);
+    if (cq_ptr_ != nullptr && cq_ptr_ != MAP_FAILED && !single_mmap_) {
+      ::munmap(cq_ptr_, cq_len_);
+    }
+    if (sq_ptr_ != nullptr && sq_ptr_ != MAP_FAILED) ::munmap(sq_ptr_, sq_len_);
+    if (fd_ >= 0) ::close(fd_);
+  }
+
+  unsigned capacity() const { return sq_entries_; }
+
+  // Queues a write; `drain` holds it until earlier requests complete and
+  // `link` chains the next queued request (the fsync) behind it.
+  void push_write(int fd, const char* data, unsigned len, std::uint64_t off,
+                  int buf_index, bool drain, bool link, std::uint64_t ud) {
+    io_uring_sqe* sqe = next_sqe();
+    if (fixed_) {
+      sqe->opcode = IORING_OP_WRITE_FIXED;
+      sqe->buf_index = static_cast<std::uint16_t>(buf_index);
+    } else {
+      sqe->opcode = IORING_OP_WRITE;
+    }
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(data);
+    sqe->len = len;
+    sqe->off = off;
+    sqe->flags = (drain ? IOSQE_IO_DRAIN : 0) | (link ? IOSQE_IO_LINK : 0);
+    sqe->user_data = ud;
+  }
+
+  void push_fsync(int fd, std::uint64_t ud) {
+    io_uring_sqe* sqe = next_sqe();
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fd;
+    sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    sqe->user_data = ud;
+  }
+
+  // Hands queued entries to the kernel; with wait_nr > 0 also blocks until
+  // that many completions are available. False on a hard error.
+  bool enter(unsigned wait_nr) {
+    for (;;) {
+      const long r =
+          ::syscall(__NR_io_uring_enter, fd_, to_submit_, wait_nr,
+                    wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+      if (r >= 0) {
+        to_submit_ -= std::min<unsigned>(to_submit_, static_cast<unsigned>(r));
+        return true;
+      }
+      if (errno == EINTR) continue;
+      // EAGAIN/EBUSY: the kernel is short on resources; the entries stay
+      // queued and go out with the next enter().
+      return errno == EAGAIN || errno == EBUSY;
+    }
+  }
+
+  template <class OnComplete>
+  void reap(OnComplete&& on_complete) {
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      on_complete(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+
+ private:
+  Ring() = default;
+
+  io_uring_sqe* next_sqe() {
+    const unsigned tail = *sq_tail_;
+    const unsigned idx = tail & sq_mask_;
+    io_uring_sqe* sqe = &sqes_[idx];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array_[idx] = idx;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++to_submit_;
+    return sqe;
+  }
+
+  int fd_ = -1;
+  bool fixed_ = false;
+  bool single_mmap_ = false;
+  void* sq_ptr_ = nullptr;
+  void* cq_ptr_ = nullptr;
+  std::size_t sq_len_ = 0;
+  std::size_t cq_len_ = 0;
+  std::size_t sqes_len_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+  unsigned to_submit_ = 0;
+};
+
+#else  // !ROVER_LOGGER_HAVE_IO_URING
+
+class UringFileSink::Ring {
+ public:
+  static std::unique_ptr<Ring> create(unsigned, const std::vector<iovec>&) {
+    return nullptr;
+  }
+  unsigned capacity() const { return 0; }
+  void push_write(int, const char*, unsigned, std::uint64_t, int, bool, bool,
+                  std::uint64_t) {}
+  void push_fsync(int, std::uint64_t) {}
+  bool enter(unsigned) { return false; }
+  template <class OnComplete>
+  void reap(OnComplete&&) {}
+};
+
+#endif  // ROVER_LOGGER_HAVE_IO_URING
+
+UringFileSink::UringFileSink(UringFileSinkOptions opt)
+    : opt_(std::move(opt)), ts_(opt_.timestamp) {
+  const std::size_t count = std::max<std::size_t>(opt_.buffer_count, 1);
+  const std::size_t bytes = std::max<std::size_t>(opt_.buffer_bytes, 256);
+  std::vector<iovec> iovs;
+  buffers_.resize(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    buffers_[i].data = std::make_unique<char[]>(bytes);
+    iovs.push_back(iovec{buffers_[i].data.get(), bytes});
+    free_buffers_.push_back(static_cast<int>(count - 1 - i));
+  }
+
+  if (opt_.use_uring) {
+    // A write plus an fsync per buffer can be queued at once.
+    ring_ = Ring::create(static_cast<unsigned>(2 * count), iovs);
+    if (ring_ && ring_->capacity() < 2 * count) ring_.reset();
+  }
+  open_next_file();
+}
+
+UringFileSink::~UringFileSink() {
+  std::scoped_lock lk(m_);
+  submit_current(false);
+  reap(true);
+  for (auto& f : files_) {
+    if (f.fd >= 0) ::close(f.fd);
+  }
+}
+
+UringFileSink::Stats UringFileSink::stats() const {
+  return Stats{inflight_bytes_.load(std::memory_order_relaxed),
+               completed_bytes_.load(std::memory_order_relaxed),
+               dropped_bytes_.load(std::memory_order_relaxed),
+               failed_bytes_.load(std::memory_order_relaxed),
+               failed_syncs_.load(std::memory_order_relaxed)};
+}
+
+bool UringFileSink::open_next_file() {
+  const std::string name =
+      opt_.base_filename + "_" + std::to_string(file_index_++) + ".log";
+  const int fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                        0644);
+  current_file_ = -1;
+  file_offset_ = 0;
+  if (fd < 0) return false;
+
+  auto slot = std::find_if(files_.begin(), files_.end(),
+                           [](const File& f) { return f.fd < 0; });
+  if (slot == files_.end()) slot = files_.insert(files_.end(), File{});
+  *slot = File{fd, 0, true};
+  current_file_ = static_cast<int>(slot - files_.begin());
+  return true;
+}
+
+void UringFileSink::close_file_if_done(int file) {
+  File& f = files_[file];
+  if (!f.current && f.pending == 0 && f.fd >= 0) {
+    ::close(f.fd);
+    f.fd = -1;
+  }
+}
+
+int UringFileSink::acquire_buffer() {
+  if (free_buffers_.empty()) reap(false);
+  if (free_buffers_.empty()) return -1;
+  const int b = free_buffers_.back();
+  free_buffers_.pop_back();
+  buffers_[b].len = 0;
+  return b;
+}
+
+void UringFileSink::append_line(const LogMessage& msg, LogLevel& highest) {
+  if (current_file_ < 0) return;
+
+  line_buf_.clear();
+  append_json_line(line_buf_, msg, ts_);
+  line_buf_.push_back('\n');
+
+  const std::size_t cap = std::max<std::size_t>(opt_.buffer_bytes, 256);
+  if (line_buf_.size() > cap) {
+    line_buf_.resize(cap - 1);
+    line_buf_.push_back('\n');
+  }
+  if (current_buf_ >= 0 && buffers_[current_buf_].len + line_buf_.size() > cap) {
+    submit_current(highest >= opt_.sync_level);
+  }
+  if (current_buf_ < 0) {
+    current_buf_ = acquire_buffer();
+    if (current_buf_ < 0) {
+      dropped_bytes_.fetch_add(line_buf_.size(), std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  Buffer& b = buffers_[current_buf_];
+  std::memcpy(b.data.get() + b.len, line_buf_.data(), line_buf_.size());
+  b.len += line_buf_.size();
+  if (msg.level > highest) highest = msg.level;
+
+  // Same rule as FileRotationSink: the crossing line stays, then rotate.
+  if (file_offset_ + b.len >= opt_.rotation_bytes) {
+    submit_current(highest >= opt_.sync_level);
+    const int old = current_file_;
+    files_[old].current = false;
+    close_file_if_done(old);
+    open_next_file();
+  }
+}
+
+void UringFileSink::submit_current(bool sync) {
+  if (current_buf_ < 0) return;
+  const int bi = current_buf_;
+  Buffer& b = buffers_[bi];
+  if (b.len == 0 || current_file_ < 0) {
+    return;  // nothing to write; keep the buffer for the next batch
+  }
+  current_buf_ = -1;
+  File& f = files_[current_file_];
+  b.file = current_file_;
+  b.offset = file_offset_;
+  b.done = 0;
+  b.sync = sync;
+
+  if (ring_) {
+    b.inflight = true;
+    inflight_bytes_.fetch_add(b.len, std::memory_order_relaxed);
+    push_buffer(bi);
+    file_offset_ += b.len;
+  } else {
+    const char* p = b.data.get();
+    std::size_t left = b.len;
+    auto off = static_cast<off_t>(file_offset_);
+    while (left > 0) {
+      const ssize_t n = ::pwrite(f.fd, p, left, off);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) break;
+      p += n;
+      off += n;
+      left -= static_cast<std::size_t>(n);
+    }
+    completed_bytes_.fetch_add(b.len - left, std::memory_order_relaxed);
+    failed_bytes_.fetch_add(left, std::memory_order_relaxed);
+    // Nothing is queued behind a blocking write, so the next one starts
+    // where this one stopped.
+    file_offset_ += b.len - left;
+    if (sync && ::fdatasync(f.fd) != 0) {
+      failed_syncs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    b.len = 0;
+    free_buffers_.push_back(bi);
+  }
+}
+
+// Queues what is left of buffer bi at its offset. A synced write waits for
+// earlier writes (drain) so the fsync that is linked behind it covers the
+// whole file so far.
+void UringFileSink::push_buffer(int bi) {
+  Buffer& b = buffers_[bi];
+  File& f = files_[b.file];
+  ring_->push_write(f.fd, b.data.get() + b.done,
+                    static_cast<unsigned>(b.len - b.done), b.offset + b.done,
+                    bi, b.sync, b.sync, make_user_data(b.file, bi, false));
+  ++f.pending;
+  if (b.sync) {
+    ring_->push_fsync(f.fd, make_user_data(b.file, bi, true));
+    ++f.pending;
+  }
+  ring_->enter(0);
+}
+
+void UringFileSink::reap(bool wait_all) {
+  if (!ring_) return;
+  auto on_complete = [&](std::uint64_t ud, int res) {
+    const int file = static_cast<int>(ud >> 32);
+    --files_[file].pending;
+    if ((ud & kFsyncFlag) != 0) {
+      // -ECANCELED means the write linked ahead of it came up short; that
+      // write is resubmitted with a new fsync or counted as failed itself.
+      if (res < 0 && res != -ECANCELED) {
+        failed_syncs_.fetch_add(1, std::memory_order_relaxed);
+      }
+    } else {
+      const int bi = static_cast<int>(ud & (kFsyncFlag - 1));
+      Buffer& b = buffers_[bi];
+      const std::size_t left = b.len - b.done;
+      File& f = files_[file];
+      if (res > 0) {
+        const std::size_t n = std::min(left, static_cast<std::size_t>(res));
+        completed_bytes_.fetch_add(n, std::memory_order_relaxed);
+        b.done += n;
+        f.written_end = std::max(f.written_end, b.offset + b.done);
+        if (b.done < b.len) {
+          push_buffer(bi);  // short write: the rest goes out on its own
+          return;
+        }
+      } else {
+        failed_bytes_.fetch_add(left, std::memory_order_relaxed);
+        f.hole = std::min(f.hole, b.offset + b.done);
+      }
+      inflight_bytes_.fetch_sub(b.len, std::memory_order_relaxed);
+      b.len = 0;
+      b.inflight = false;
+      free_buffers_.push_back(bi);
+    }
+    // If every write from the first failed byte on failed too, the next one
+    // starts there rather than leaving NULs in the file.
+    File& f = files_[file];
+    if (file == current_file_ && f.pending == 0 &&
+        f.hole != ~std::uint64_t{0}) {
+      if (f.written_end <= f.hole) file_offset_ = f.hole;
+      f.hole = ~std::uint64_t{0};
+    }
+    close_file_if_done(file);
+  };
+
+  ring_->reap(on_complete);
+  if (!wait_all) return;
+  auto pending = [&] {
+    return std::any_of(files_.begin(), files_.end(),
+                       [](const File& f) { return f.pending > 0; });
+  };
+  while (pending() && ring_->enter(1)) {
+    ring_->reap(on_complete);
+  }
+}
+
+void UringFileSink::write(const LogMessage& msg) { write_batch(&msg, 1); }
+
+void UringFileSink::write_batch(const LogMessage* msgs, std::size_t count) {
+  std::scoped_lock lk(m_);
+  reap(false);
+  LogLevel highest = LogLevel::TRACE;
+  for (std::size_t i = 0; i < count; ++i) append_line(msgs[i], highest);
+  submit_current(highest >= opt_.sync_level);
+}
+
+void UringFileSink::flush() {
+  std::scoped_lock lk(m_);
+  submit_current(false);
+  reap(false);
+}
+
+void UringFileSink::sync() {
+  std::scoped_lock lk(m_);
+  submit_current(false);
+  reap(true);
+  if (current_file_ >= 0 && files_[current_file_].fd >= 0 &&
+      ::fdatasync(files_[current_file_].fd) != 0) {
+    failed_syncs_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace rover_logger
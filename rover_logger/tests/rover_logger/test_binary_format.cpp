@@ -0,0 +1,135 @@
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rover_logger/binary_format.hpp"
+#include "rover_logger/file_rotation_adapter.hpp"
+#include "rover_logger/json_formatter.hpp"
+#include "rover_logger/log_message.hpp"
+
+namespace fs = std::filesystem;
+using namespace rover_logger;
+
+static std::int64_t ns_of(const LogMessage& m) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             m.ts.time_since_epoch())
+      .count();
+}
+
+int main() {
+  for (auto& e : fs::directory_iterator(".")) {
+    auto n = e.path().filename().string();
+    if (n.rfind("rover_bin_", 0) == 0) fs::remove(e);
+  }
+
+  // Messages over a few modules and levels, timestamps not monotonic.
+  const char* modules[] = {"/nav", "/drive", "/vision/stereo"};
+  std::vector<LogMessage> msgs;
+  for (int i = 0; i < 300; ++i) {
+    msgs.emplace_back(static_cast<LogLevel>(i % 6), modules[i % 3],
+                      "pose x=" + std::to_string(i) + " y=" + std::to_string(i * 7));
+    if (i % 10 == 3) msgs.back().ts -= std::chrono::milliseconds(5);
+  }
+
+  // 1) In-memory round trip through two concatenated "files".
+  {
+    BinaryLogEncoder enc;
+    std::string buf;
+    enc.begin_file(buf);
+    for (std::size_t i = 0; i < 150; ++i) enc.append(buf, msgs[i]);
+    enc.begin_file(buf);
+    for (std::size_t i = 150; i < msgs.size(); ++i) enc.append(buf, msgs[i]);
+
+    std::istringstream in(buf);
+    BinaryLogDecoder dec(in);
+    DecodedRecord rec;
+    std::size_t n = 0;
+    while (dec.next(rec) == BinaryLogDecoder::Status::Record) {
+      const auto& m = msgs[n++];
+      assert(rec.ts_ns == ns_of(m));
+      assert(rec.level == m.level);
+      assert(rec.module == m.module.view());
+      assert(rec.text == m.text.view());
+    }
+    assert(n == msgs.size());
+
+    // Truncated input is reported, not misread.
+    std::istringstream cut(buf.substr(0, buf.size() - 3));
+    BinaryLogDecoder dec2(cut);
+    auto st = BinaryLogDecoder::Status::Record;
+    while ((st = dec2.next(rec)) == BinaryLogDecoder::Status::Record) {
+    }
+    assert(st == BinaryLogDecoder::Status::Corrupt);
+
+    // Not a binary log at all.
+    std::istringstream text("{\"level\":\"INFO\"}\n");
+    BinaryLogDecoder dec3(text);
+    assert(dec3.next(rec) == BinaryLogDecoder::Status::Corrupt);
+
+    // Absurd or unbacked lengths are rejected without allocating them.
+    std::istringstream huge("\xff\xff\xff\xff\xff\xff\xff\xff\x7f");
+    BinaryLogDecoder dec4(huge);
+    assert(dec4.next(rec) == BinaryLogDecoder::Status::Corrupt);
+    std::string short_body;
+    short_body.push_back('\x80');
+    short_body.push_back('\x80');
+    short_body.push_back('\x04');  // 64 KiB claimed, 3 bytes present
+    short_body.append("abc");
+    std::istringstream cut_body(short_body);
+    BinaryLogDecoder dec5(cut_body);
+    assert(dec5.next(rec) == BinaryLogDecoder::Status::Corrupt);
+  }
+
+  // 2) Through the file adapter with rotation: every file decodes on its
+  //    own (header + module dictionary per file) and nothing is lost.
+  {
+    FileRotationAdapterOptions opt;
+    opt.base_filename = "rover_bin";
+    opt.rotation_bytes = 2048;
+    opt.format = AdaptFormat::Binary;
+    {
+      FileRotationAdapter adapter(opt);
+      adapter.write_batch(msgs.data(), 100);
+      for (std::size_t i = 100; i < msgs.size(); ++i) adapter.write(msgs[i]);
+    }
+
+    std::size_t n = 0;
+    std::size_t files = 0;
+    std::uintmax_t binary_bytes = 0;
+    for (int idx = 0;; ++idx) {
+      const std::string name = "rover_bin_" + std::to_string(idx) + ".log";
+      if (!fs::exists(name)) break;
+      ++files;
+      binary_bytes += fs::file_size(name);
+      std::ifstream in(name, std::ios::binary);
+      BinaryLogDecoder dec(in);
+      DecodedRecord rec;
+      BinaryLogDecoder::Status st;
+      while ((st = dec.next(rec)) == BinaryLogDecoder::Status::Record) {
+        const auto& m = msgs[n++];
+        assert(rec.ts_ns == ns_of(m));
+        assert(rec.level == m.level);
+        assert(rec.module == m.module.view());
+        assert(rec.text == m.text.view());
+      }
+      assert(st == BinaryLogDecoder::Status::End);
+      fs::remove(name);
+    }
+    assert(files > 2);
+    assert(n == msgs.size());
+
+    // Same messages as JSON lines for comparison.
+    std::size_t json_bytes = 0;
+    for (const auto& m : msgs) json_bytes += to_json_line(m).size() + 1;
+    std::cout << "binary " << binary_bytes << " bytes vs json " << json_bytes
+              << " bytes\n";
+    assert(binary_bytes * 2 < json_bytes);
+  }
+
+  std::cout << "test_binary_format OK\n";
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rover_logger/bounded_queue.hpp"
+
+using namespace rover_logger;
+
+int main() {
+  // 1) FIFO order and drop-oldest semantics on a full ring
+  {
+    BoundedQueue<std::string> q(4);
+    for (int i = 0; i < 6; ++i) {
+      std::size_t dropped = q.push_drop_oldest("item" + std::to_string(i));
+      assert(dropped == (i < 4 ? 0u : 1u));
+    }
+    assert(q.peak() == 4);
+
+    std::string out;
+    for (int i = 2; i < 6; ++i) {
+      assert(q.try_pop(out));
+      assert(out == "item" + std::to_string(i));  // item0/item1 were evicted
+    }
+    assert(!q.try_pop(out));
+  }
+
+  // 2) Many producers, one blocking consumer: nothing is lost or duplicated
+  //    (popped + dropped == pushed) and the peak never exceeds capacity.
+  {
+    BoundedQueue<int> q(64);
+    const int producers = 8;
+    const int per = 20000;
+    std::atomic<std::uint64_t> dropped{0};
+
+    std::uint64_t popped = 0;
+    std::thread consumer([&] {
+      int v = 0;
+      while (q.pop_wait(v)) ++popped;
+    });
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < per; ++i) {
+          dropped.fetch_add(q.push_drop_oldest(int{i}));
+        }
+      });
+    }
+    for (auto& t : threads) t.join();
+    q.request_stop();
+    consumer.join();
+
+    assert(popped + dropped.load() ==
+           static_cast<std::uint64_t>(producers) * per);
+    assert(q.peak() <= 64);
+  }
+
+  // 3) Batch pop respects max, and linger collects late arrivals
+  {
+    BoundedQueue<int> q(128);
+    for (int i = 0; i < 10; ++i) q.push_drop_oldest(int{i});
+
+    std::vector<int> batch;
+    assert(q.pop_wait_batch(batch, 4));
+    assert(batch.size() == 4 && batch.front() == 0 && batch.back() == 3);
+    batch.clear();
+    assert(q.pop_wait_batch(batch, 100));
+    assert(batch.size() == 6 && batch.back() == 9);
+
+    std::thread late([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      q.push_drop_oldest(11);
+    });
+    q.push_drop_oldest(10);
+    batch.clear();
+    assert(q.pop_wait_batch(batch, 2, std::chrono::milliseconds(2000)));
+    late.join();
+    assert(batch.size() == 2 && batch[0] == 10 && batch[1] == 11);
+
+    q.request_stop();
+    batch.clear();
+    assert(!q.pop_wait_batch(batch, 8));
+  }
+
+  // 4) push_if_space leaves the item alone when full; push_wait waits for
+  //    the consumer (or times out, or gives up on stop).
+  {
+    BoundedQueue<std::string> q(2);
+    std::string a = "a", b = "b", c = "c";
+    assert(q.push_if_space(a) && q.push_if_space(b));
+    assert(!q.push_if_space(c) && c == "c");
+
+    const auto t0 = std::chrono::steady_clock::now();
+    assert(!q.push_wait(c, std::chrono::milliseconds(30)));
+    assert(std::chrono::steady_clock::now() - t0 >= std::chrono::milliseconds(25));
+    assert(c == "c");
+
+    std::thread consumer([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      std::string out;
+      assert(q.try_pop(out) && out == "a");
+    });
+    assert(q.push_wait(c, std::chrono::microseconds(-1)));
+    consumer.join();
+
+    std::string out;
+    assert(q.try_pop(out) && out == "b");
+    assert(q.try_pop(out) && out == "c");
+
+    std::string d = "d", e = "e", f = "f";
+    q.push_if_space(d);
+    q.push_if_space(e);
+    std::thread stopper([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      q.request_stop();
+    });
+    assert(!q.push_wait(f, std::chrono::microseconds(-1)));
+    stopper.join();
+  }
+
+  std::cout << "OK: test_bounded_queue passed.\n";
+  return 0;
+}
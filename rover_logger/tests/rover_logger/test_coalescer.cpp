@@ -0,0 +1,199 @@
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rover_logger/coalescer.hpp"
+#include "rover_logger/logger.hpp"
+
+using namespace rover_logger;
+using namespace std::chrono_literals;
+
+// Keeps the text of every message it is given.
+class TextSink : public ILogSink {
+ public:
+  void write(const LogMessage& msg) override {
+    std::scoped_lock lk(m_);
+    lines_.emplace_back(msg.text.view());
+  }
+  std::vector<std::string> lines() {
+    std::scoped_lock lk(m_);
+    return lines_;
+  }
+
+ private:
+  std::mutex m_;
+  std::vector<std::string> lines_;
+};
+
+static LogMessage at(LogMessage::clock::time_point ts, LogLevel lv,
+                     const char* module, const char* text) {
+  LogMessage m{lv, module, text};
+  m.ts = ts;
+  return m;
+}
+
+static bool starts_with(const std::string& s, const std::string& prefix) {
+  return s.rfind(prefix, 0) == 0;
+}
+
+int main() {
+  const auto t0 = LogMessage::clock::time_point{} + std::chrono::hours(24 * 365 * 55);
+
+  // 1) Repeats within the window collapse into one summary; module, level
+  //    and text all have to match
+  {
+    Coalescer c(1000ms, 8);
+    std::vector<LogMessage> in;
+    for (int i = 0; i < 100; ++i) {
+      in.push_back(at(t0 + i * 1ms, LogLevel::ERROR, "/imu", "imu timeout"));
+    }
+    in.push_back(at(t0 + 100ms, LogLevel::WARN, "/imu", "imu timeout"));
+    in.push_back(at(t0 + 101ms, LogLevel::ERROR, "/gps", "imu timeout"));
+    in.push_back(at(t0 + 102ms, LogLevel::ERROR, "/imu", "other"));
+    std::vector<LogMessage> out;
+    c.process(in.data(), in.size(), out);
+    assert(out.size() == 4);
+    assert(out[0].text == "imu timeout" && out[0].ts == t0);
+    assert(c.coalesced() == 99);
+    assert(c.next_due() == t0 + 1000ms);
+
+    out.clear();
+    c.expire(t0 + 999ms, out);
+    assert(out.empty());
+    c.expire(t0 + 1000ms, out);
+    assert(out.size() == 1);
+    const std::string sum(out[0].text.view());
+    assert(starts_with(sum, "imu timeout [repeated 99 times, first "));
+    assert(sum.find(", last ") != std::string::npos && sum.back() == ']');
+    assert(out[0].ts == t0 + 99ms && out[0].level == LogLevel::ERROR);
+    assert(out[0].module == "/imu");
+    // Only windows with repeats produce output.
+    assert(!c.next_due());
+    out.clear();
+    c.expire_all(out);
+    assert(out.empty());
+  }
+
+  // 2) A repeat after the window closed starts a new window
+  {
+    Coalescer c(100ms, 8);
+    std::vector<LogMessage> in = {
+        at(t0, LogLevel::ERROR, "/imu", "x"),
+        at(t0 + 50ms, LogLevel::ERROR, "/imu", "x"),
+        at(t0 + 150ms, LogLevel::ERROR, "/imu", "x"),
+    };
+    std::vector<LogMessage> out;
+    c.process(in.data(), in.size(), out);
+    assert(out.size() == 3);
+    assert(out[0].text == "x");
+    assert(starts_with(std::string(out[1].text.view()), "x [repeated 1 times"));
+    assert(out[2].text == "x" && out[2].ts == t0 + 150ms);
+  }
+
+  // 3) Bounded: the oldest window closes early when the table is full
+  {
+    Coalescer c(10s, 2);
+    std::vector<LogMessage> in = {
+        at(t0, LogLevel::INFO, "/a", "a"),
+        at(t0 + 1ms, LogLevel::INFO, "/a", "a"),
+        at(t0 + 2ms, LogLevel::INFO, "/b", "b"),
+        at(t0 + 3ms, LogLevel::INFO, "/c", "c"),
+    };
+    std::vector<LogMessage> out;
+    c.process(in.data(), in.size(), out);
+    assert(out.size() == 4);
+    assert(out[1].text == "b");
+    assert(starts_with(std::string(out[2].text.view()), "a [repeated 1 times"));
+    assert(out[3].text == "c");
+    out.clear();
+    c.expire_all(out);
+    assert(out.empty());  // b and c were never repeated
+  }
+
+  // 4) A full table keeps working as windows close and reopen: cycling
+  //    through more texts than it holds never matches, as many matches
+  //    every time; the next summary due is the oldest window with repeats.
+  {
+    Coalescer c(10s, 16);
+    std::vector<LogMessage> in;
+    std::vector<std::string> texts;
+    for (int i = 0; i < 2000; ++i) texts.push_back("t" + std::to_string(i % 20));
+    for (const auto& t : texts) {
+      in.push_back(at(t0, LogLevel::INFO, "/cycle", t.c_str()));
+    }
+    std::vector<LogMessage> out;
+    c.process(in.data(), in.size(), out);
+    assert(out.size() == 2000 && c.coalesced() == 0 && !c.next_due());
+
+    Coalescer d(10s, 16);
+    in.clear();
+    texts.clear();
+    for (int i = 0; i < 2000; ++i) texts.push_back("t" + std::to_string(i % 16));
+    for (std::size_t i = 0; i < texts.size(); ++i) {
+      in.push_back(at(t0 + i * 1ms, LogLevel::INFO, "/cycle", texts[i].c_str()));
+    }
+    out.clear();
+    d.process(in.data(), in.size(), out);
+    assert(out.size() == 16 && d.coalesced() == 1984);
+    assert(d.next_due() == t0 + 10s);
+    out.clear();
+    d.expire(t0 + 10s + 5ms, out);
+    assert(out.size() == 6 && d.next_due() == t0 + 6ms + 10s);
+    d.expire_all(out);
+    assert(out.size() == 16 && !d.next_due());
+  }
+
+  // 5) Through the Logger, per sink: the summary is written once its
+  //    window passes, even with no further traffic
+  for (DispatchMode dispatch : {DispatchMode::Inline, DispatchMode::PerSink}) {
+    LoggerConfig cfg;
+    cfg.dispatch = dispatch;
+    cfg.flush_interval_ms = 0;  // only the coalescer should wake the writer
+    Logger log(cfg);
+    auto plain = std::make_shared<TextSink>();
+    auto coalesced = std::make_shared<TextSink>();
+    log.add_sink(plain);
+    CoalesceConfig cc;
+    cc.window_ms = 50;
+    log.add_sink(coalesced, cc);
+
+    for (int i = 0; i < 1000; ++i) {
+      log.log(LogMessage{LogLevel::ERROR, "/lidar", "no data"});
+    }
+    for (int i = 0; i < 2000 && coalesced->lines().size() < 2; ++i) {
+      std::this_thread::sleep_for(1ms);
+    }
+    assert(plain->lines().size() == 1000);
+    const auto lines = coalesced->lines();
+    assert(lines.size() == 2);
+    assert(lines[0] == "no data");
+    assert(starts_with(lines[1], "no data [repeated 999 times, first "));
+
+    const LoggerMetrics m = log.metrics_snapshot();
+    assert(m.sinks[0].coalesced == 0 && m.sinks[0].written == 1000);
+    assert(m.sinks[1].coalesced == 999 && m.sinks[1].written == 2);
+  }
+
+  // 6) Pending summaries are written on shutdown
+  {
+    auto sink = std::make_shared<TextSink>();
+    {
+      Logger log(1024);
+      CoalesceConfig cc;
+      cc.window_ms = 60'000;
+      log.add_sink(sink, cc);
+      log.log(LogMessage{LogLevel::WARN, "/arm", "joint limit"});
+      log.log(LogMessage{LogLevel::WARN, "/arm", "joint limit"});
+    }
+    const auto lines = sink->lines();
+    assert(lines.size() == 2);
+    assert(starts_with(lines[1], "joint limit [repeated 1 times"));
+  }
+
+  std::cout << "OK: test_coalescer passed.\n";
+  return 0;
+}
@@ -18,6 +18,20 @@ int main() {
   const char* YAML_TEXT = R"YAML(
 level: warn
 max_queue: 2048
+queue_mode: per_thread
+overflow: level-aware
+block_timeout_ms: 25
+dispatch: per_sink
+sink_queue: 512
+batch_max: 64
+batch_linger_ms: 5
+flush_interval_ms: 250
+emergency_level: error
+flight_recorder:
+  level: debug
+  records_per_thread: 2048
+  path: /tmp/rover_flight.log
+  dump_on_exit: true
 sinks:
   - type: terminal
     colorize: false
@@ -26,9 +40,21 @@ sinks:
     rotation_bytes: 1048576
     rotate_keep: 5
     compress: true
+    format: binary
+    timestamp: epoch_us
+    flush_level: error
+    sync_level: fatal
+    coalesce_window_ms: 2000
+    coalesce_entries: 32
 modules:
   /drive: error
-  /vision: info
+  /vision:
+    level: info
+    rate_limit: 50
+    sample: 10
+  /vision/stereo:
+    burst: 7
+    rate_limit: 2.5
 )YAML";
 
   // Write YAML to a temp file
@@ -40,6 +66,22 @@ modules:
   // Global
   assert(cfg.level == LogLevel::WARN);
   assert(cfg.max_queue == 2048);
+  assert(cfg.queue_mode == QueueMode::PerThread);
+  assert(cfg.overflow == OverflowPolicy::LevelAware);
+  assert(cfg.block_timeout_ms == 25);
+  assert(cfg.dispatch == DispatchMode::PerSink);
+  assert(cfg.sink_queue == 512);
+  assert(cfg.batch_max == 64);
+  assert(cfg.batch_linger_ms == 5);
+  assert(cfg.flush_interval_ms == 250);
+  assert(cfg.emergency_level == LogLevel::ERROR);
+  assert(LoggerConfig{}.emergency_level == LogLevel::FATAL);
+  assert(cfg.flight_recorder.enabled);  // implied by the section
+  assert(cfg.flight_recorder.level == LogLevel::DEBUG);
+  assert(cfg.flight_recorder.records_per_thread == 2048);
+  assert(cfg.flight_recorder.path == "/tmp/rover_flight.log");
+  assert(cfg.flight_recorder.on_signal);
+  assert(cfg.flight_recorder.dump_on_exit);
 
   // Sinks
   assert(cfg.sinks.size() == 2);
@@ -52,11 +94,27 @@ modules:
   assert(cfg.sinks[1].rotation_bytes.has_value() && cfg.sinks[1].rotation_bytes.value() == 1048576u);
   assert(cfg.sinks[1].rotate_keep.has_value() && cfg.sinks[1].rotate_keep.value() == 5);
   assert(cfg.sinks[1].compress.has_value() && cfg.sinks[1].compress.value() == true);
+  assert(cfg.sinks[1].format.value_or("") == "binary");
+  assert(cfg.sinks[1].timestamp.value_or("") == "epoch_us");
+  assert(cfg.sinks[1].flush_level == LogLevel::ERROR);
+  assert(cfg.sinks[1].sync_level == LogLevel::FATAL);
+  assert(!cfg.sinks[0].flush_level.has_value());
+  assert(cfg.sinks[1].coalesce_window_ms.value_or(0) == 2000);
+  assert(cfg.sinks[1].coalesce_entries.value_or(0) == 32);
+  assert(!cfg.sinks[0].coalesce_window_ms.has_value());
+  assert(parse_timestamp_format("ISO8601_NS") == TimestampFormat::Iso8601Nanos);
 
   // Modules
   assert(cfg.modules.size() == 2);
   assert(cfg.modules.at("/drive") == LogLevel::ERROR);
   assert(cfg.modules.at("/vision") == LogLevel::INFO);
+  assert(cfg.module_limits.size() == 2);
+  assert(cfg.module_limits.at("/vision").rate == 50);
+  assert(cfg.module_limits.at("/vision").burst == 0);
+  assert(cfg.module_limits.at("/vision").sample == 10);
+  assert(cfg.module_limits.at("/vision/stereo").rate == 2.5);
+  assert(cfg.module_limits.at("/vision/stereo").burst == 7);
+  assert(cfg.module_limits.at("/vision/stereo").sample == 1);
 
   // parse_level edge cases
   try {
@@ -69,6 +127,35 @@ modules:
     // expected
   }
 
+  // parse_queue_mode
+  assert(parse_queue_mode("shared") == QueueMode::Shared);
+  try {
+    (void)parse_queue_mode("sideways");
+    assert(false && "unknown queue mode should throw");
+  } catch (const std::invalid_argument&) {
+    // expected
+  }
+
+  // parse_overflow_policy
+  assert(parse_overflow_policy("DROP_NEWEST") == OverflowPolicy::DropNewest);
+  assert(parse_overflow_policy("block") == OverflowPolicy::Block);
+  try {
+    (void)parse_overflow_policy("drop_random");
+    assert(false && "unknown overflow policy should throw");
+  } catch (const std::invalid_argument&) {
+    // expected
+  }
+
+  // parse_dispatch_mode
+  assert(parse_dispatch_mode("Inline") == DispatchMode::Inline);
+  assert(parse_dispatch_mode("per-sink") == DispatchMode::PerSink);
+  try {
+    (void)parse_dispatch_mode("pool");
+    assert(false && "unknown dispatch mode should throw");
+  } catch (const std::invalid_argument&) {
+    // expected
+  }
+
   std::cout << "OK: test_config passed.\n";
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rover_logger/api.hpp"
+#include "rover_logger/deferred_format.hpp"
+
+using namespace rover_logger;
+
+// Captures like the RVLOG_* macros do, formats like the worker does.
+template <class... Args>
+static std::string roundtrip(const char* fmt, const Args&... args) {
+  LogMessage m{LogLevel::INFO, "fmt.test", ""};
+  capture_deferred(m, fmt, deferred_detail::decay_arg(args)...);
+  assert(m.deferred());
+  std::string scratch;
+  format_deferred(m, scratch);
+  assert(!m.deferred());
+  return std::string(m.text.view());
+}
+
+class TextSink : public ILogSink {
+ public:
+  void write(const LogMessage& msg) override {
+    std::scoped_lock lk(m_);
+    lines_.emplace_back(msg.text.view());
+  }
+  std::vector<std::string> lines() {
+    std::scoped_lock lk(m_);
+    return lines_;
+  }
+
+ private:
+  std::mutex m_;
+  std::vector<std::string> lines_;
+};
+
+int main() {
+  // 1) Output matches snprintf for common conversions
+  char expect[256];
+  std::snprintf(expect, sizeof(expect), "x=%d y=%5.2f id=%08x s=%-6s|%c%%",
+                -42, 3.14159, 0xbeefu, "ab", 'Z');
+  assert(roundtrip("x=%d y=%5.2f id=%08x s=%-6s|%c%%", -42, 3.14159, 0xbeefu,
+                   "ab", 'Z') == expect);
+
+  std::snprintf(expect, sizeof(expect), "%ld %llu %hhd %*d|%.*s", 1234567890L,
+                18446744073709551615ull, 300, 6, 7, 3, "abcdef");
+  assert(roundtrip("%ld %llu %hhd %*d|%.*s", 1234567890L,
+                   18446744073709551615ull, 300, 6, 7, 3, "abcdef") == expect);
+
+  // 2) Strings are copied at capture time
+  {
+    std::string volatile_text = "before";
+    LogMessage m{LogLevel::INFO, "fmt.test", ""};
+    capture_deferred(m, "v=%s", deferred_detail::decay_arg(volatile_text));
+    volatile_text = "after!";
+    std::string scratch;
+    format_deferred(m, scratch);
+    assert(m.text == "v=before");
+  }
+
+  // 3) std::string / string_view arguments, missing arguments
+  assert(roundtrip("%s/%s", std::string("a"), std::string_view("b")) == "a/b");
+  assert(roundtrip("n=%d") == "n=<missing>");
+  assert(roundtrip("%s", static_cast<const char*>(nullptr)) == "(null)");
+
+  // 4) Long argument payloads spill but still format correctly
+  const std::string big(600, 'q');
+  assert(roundtrip("[%s]", big) == "[" + big + "]");
+
+  // 5) End to end through the macros: sinks only ever see formatted text
+  {
+    auto sink = std::make_shared<TextSink>();
+    {
+      Logger log(64);
+      log.add_sink(sink);
+      log.set_min_level(LogLevel::TRACE);
+      RVLOG_INFO(log, "/drive", "Speed=%d heading=%.1f", 12, 90.0);
+      RVLOG_WARN(log, std::string("/drive"), "Low battery: %.2f volts", 6.52);
+      static const ModuleHandle kDrive{"/drive"};
+      RVLOG_ERROR(log, kDrive, "Stalled after %d ms", 250);
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    auto lines = sink->lines();
+    assert(lines.size() == 3);
+    assert(lines[0] == "Speed=12 heading=90.0");
+    assert(lines[1] == "Low battery: 6.52 volts");
+    assert(lines[2] == "Stalled after 250 ms");
+  }
+
+  // 6) Disabled statements do not evaluate their arguments
+  {
+    auto sink = std::make_shared<TextSink>();
+    int evaluated = 0;
+    auto touch = [&evaluated] { return ++evaluated; };
+    {
+      Logger log(64);
+      log.add_sink(sink);
+      log.set_min_level(LogLevel::WARN);
+      assert(!log.level_enabled(LogLevel::INFO));
+      RVLOG_DEBUG(log, "/drive", "n=%d", touch());
+      RVLOG_INFO(log, "/drive", "n=%d", touch());
+      assert(evaluated == 0);
+
+      // A module override lowers the floor for that module only.
+      log.set_module_level("/vision", LogLevel::DEBUG);
+      assert(log.level_enabled(LogLevel::DEBUG));
+      assert(!log.level_enabled(LogLevel::TRACE));
+      RVLOG_DEBUG(log, "/vision", "v=%d", touch());
+      RVLOG_DEBUG(log, "/drive", "d=%d", 7);
+      // With a handle the module's own level is checked up front.
+      static const ModuleHandle kDrive{"/drive"};
+      RVLOG_DEBUG(log, kDrive, "h=%d", touch());
+      RVLOG_INFO_EVERY_N(log, kDrive, 2, "h=%d", touch());
+      log.clear_module_level("/vision");
+      assert(!log.level_enabled(LogLevel::DEBUG));
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    assert(evaluated == 1);
+    auto lines = sink->lines();
+    assert(lines.size() == 1);
+    assert(lines[0] == "v=1");
+  }
+
+  std::cout << "OK: test_deferred_format passed.\n";
+  return 0;
+}
@@ -1,6 +1,9 @@
 #include <cassert>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <thread>
+#include <vector>
 #include "rover_logger/file_rotation_adapter.hpp"
 #include "rover_logger/log_message.hpp"
 
@@ -33,6 +36,66 @@ int main() {
   }
   assert(base && rotated);
 
+  // Batched path: one buffer per batch, same rotation rule, no lost lines.
+  {
+    FileRotationAdapterOptions bopt;
+    bopt.base_filename = "rover_batch";
+    bopt.rotation_bytes = 400;
+    bopt.format = AdaptFormat::Text;
+    FileRotationAdapter batched(bopt);
+
+    std::vector<LogMessage> msgs;
+    for (int i = 0; i < 30; ++i)
+      msgs.emplace_back(LogLevel::WARN, "merge.demo", "batch-" + std::to_string(i) + std::string(40, 'y'));
+    batched.write_batch(msgs.data(), msgs.size());
+
+    std::size_t lines = 0;
+    for (auto& e : fs::directory_iterator(".")) {
+      auto n = e.path().filename().string();
+      if (n.rfind("rover_batch_", 0) != 0) continue;
+      std::ifstream in(e.path());
+      for (std::string l; std::getline(in, l);) ++lines;
+      fs::remove(e);
+    }
+    assert(lines == msgs.size());
+  }
+
+  // Flush policy: INFO stays buffered, WARN+ is written through, flush()
+  // and the Logger's periodic flush push out whatever is left.
+  {
+    auto lines_in = [](const std::string& path) {
+      std::ifstream in(path);
+      std::size_t n = 0;
+      for (std::string l; std::getline(in, l);) ++n;
+      return n;
+    };
+    FileRotationAdapterOptions popt;
+    popt.base_filename = "rover_policy";
+    popt.rotation_bytes = 1 << 20;
+    popt.format = AdaptFormat::Text;
+    auto policy = std::make_shared<FileRotationAdapter>(popt);
+
+    policy->write(LogMessage{LogLevel::INFO, "policy", "buffered"});
+    assert(lines_in("rover_policy_0.log") == 0);
+    policy->write(LogMessage{LogLevel::WARN, "policy", "written"});
+    assert(lines_in("rover_policy_0.log") == 2);
+    policy->write(LogMessage{LogLevel::DEBUG, "policy", "buffered"});
+    policy->flush();
+    assert(lines_in("rover_policy_0.log") == 3);
+
+    LoggerConfig lc;
+    lc.flush_interval_ms = 20;
+    {
+      Logger log(lc);
+      log.add_sink(policy);
+      log.set_min_level(LogLevel::TRACE);
+      log.log(LogMessage{LogLevel::INFO, "policy", "periodic"});
+      std::this_thread::sleep_for(std::chrono::milliseconds(300));
+      assert(lines_in("rover_policy_0.log") == 4);
+    }
+    fs::remove("rover_policy_0.log");
+  }
+
   std::cout << "OK: test_file_rotation_adapter passed.\n";
   return 0;
 }
@@ -0,0 +1,199 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rover_logger/api.hpp"
+#include "rover_logger/flight_recorder.hpp"
+#include "rover_logger/logger.hpp"
+
+namespace fs = std::filesystem;
+using namespace rover_logger;
+
+class CountingSink : public ILogSink {
+ public:
+  void write(const LogMessage&) override {
+    count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<std::uint64_t> count_{0};
+};
+
+static std::vector<std::string> read_lines(const std::string& path) {
+  std::vector<std::string> lines;
+  std::ifstream in(path);
+  for (std::string l; std::getline(in, l);) lines.push_back(l);
+  return lines;
+}
+
+static bool contains(const std::vector<std::string>& lines, const std::string& s) {
+  return std::any_of(lines.begin(), lines.end(), [&](const std::string& l) {
+    return l.find(s) != std::string::npos;
+  });
+}
+
+static LoggerConfig recorder_cfg(const std::string& path, bool on_signal) {
+  LoggerConfig cfg;
+  cfg.max_queue = 1024;
+  cfg.flight_recorder.enabled = true;
+  cfg.flight_recorder.path = path;
+  cfg.flight_recorder.records_per_thread = 128;
+  cfg.flight_recorder.on_signal = on_signal;
+  return cfg;
+}
+
+// Recurses until the thread's stack runs out.
+static int overflow(int depth) {
+  volatile char pad[1024];
+  pad[0] = static_cast<char>(depth);
+  if (depth == -1) return 0;
+  return overflow(depth + 1) + pad[0];
+}
+
+int main() {
+  for (auto& e : fs::directory_iterator(".")) {
+    auto n = e.path().filename().string();
+    if (n.rfind("rover_fr_", 0) == 0) fs::remove(e);
+  }
+
+  // 1) Per-thread rings keep each thread's newest records; the dump
+  //    merges them in timestamp order.
+  {
+    FlightRecorder rec("rover_fr_rings.log", 64);
+    rec.record(LogMessage{LogLevel::WARN, "/fr/long", std::string(300, 'x')});
+    std::atomic<int> done{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+      threads.emplace_back([&rec, &done, t] {
+        const std::string mod = "/fr/t" + std::to_string(t);
+        for (int i = 0; i < 1000; ++i) {
+          rec.record(LogMessage{LogLevel::INFO, mod, "n=" + std::to_string(i)});
+        }
+        // Stay alive until all have recorded, or they would share a ring.
+        done.fetch_add(1);
+        while (done.load() < 3) std::this_thread::yield();
+      });
+    }
+    for (auto& th : threads) th.join();
+    assert(rec.unrecorded() == 0);
+    assert(rec.dump("test"));
+
+    const auto lines = read_lines("rover_fr_rings.log");
+    assert(lines.front().rfind("==== rover_logger flight recorder: test", 0) == 0);
+    assert(lines.back() == "==== end of flight recorder dump ====");
+    assert(lines.size() == 2 + 3 * 64 + 1);
+    for (std::size_t i = 2; i + 1 < lines.size(); ++i) {
+      assert(lines[i].substr(0, 30) >= lines[i - 1].substr(0, 30));
+    }
+    for (int t = 0; t < 3; ++t) {
+      const std::string mod = "[/fr/t" + std::to_string(t) + "] ";
+      assert(contains(lines, mod + "n=999"));
+      assert(contains(lines, mod + "n=936"));
+      assert(!contains(lines, mod + "n=935"));
+    }
+    // Exited threads' rings are reused, not grown.
+    std::thread([&rec] {
+      rec.record(LogMessage{LogLevel::INFO, "/fr/late", "late"});
+    }).join();
+    assert(rec.dump("again"));
+    const auto again = read_lines("rover_fr_rings.log");
+    assert(contains(again, "(pid ") && contains(again, "[/fr/late] late"));
+    assert(contains(again, "WARN [/fr/long] " + std::string(224, 'x') + "..."));
+  }
+
+  // 2) Through the Logger: messages below the level filter reach only the
+  //    recorder, deferred arguments are rendered at dump time, and FATAL
+  //    dumps before log() returns.
+  {
+    Logger log(recorder_cfg("rover_fr_logger.log", false));
+    auto sink = std::make_shared<CountingSink>();
+    log.add_sink(sink);
+    log.set_min_level(LogLevel::INFO);
+    assert(log.level_enabled(LogLevel::TRACE));
+    assert(!log.should_log(LogLevel::TRACE, ModuleRegistry::kUnknown));
+
+    static const ModuleHandle kNav{"/fr/nav"};
+    RVLOG_TRACE(log, kNav, "pose x=%d y=%.2f frame=%s id=%x", 42, 1.5, "map", 255u);
+    RVLOG_INFO(log, kNav, "info %u", 7u);
+    log_printf(log, LogLevel::DEBUG, "/fr/printf", "printf %d", 3);
+    log.log(LogMessage{LogLevel::DEBUG, "/fr/plain", "plain"});
+    for (int i = 0; i < 2000 && log.processed_total() < 1; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(sink->count() == 1);
+    assert(!fs::exists("rover_fr_logger.log"));
+
+    RVLOG_FATAL(log, kNav, "fatal %s", "boom");
+    const auto lines = read_lines("rover_fr_logger.log");
+    assert(lines.front().rfind("==== rover_logger flight recorder: FATAL", 0) == 0);
+    assert(contains(lines, "TRACE [/fr/nav] pose x=42 y=1.50 frame=map id=ff"));
+    assert(contains(lines, "INFO [/fr/nav] info 7"));
+    assert(contains(lines, "DEBUG [/fr/printf] printf 3"));
+    assert(contains(lines, "DEBUG [/fr/plain] plain"));
+    assert(contains(lines, "FATAL [/fr/nav] fatal boom"));
+    assert(log.dump_flight_recorder());
+  }
+  {
+    // Without a recorder the filter stays strict.
+    Logger log(1024);
+    log.set_min_level(LogLevel::INFO);
+    assert(!log.level_enabled(LogLevel::TRACE));
+    assert(!log.dump_flight_recorder());
+  }
+
+  // 3) A crashing process dumps from its signal handler, then dies of the
+  //    original signal.
+  {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      Logger log(recorder_cfg("rover_fr_crash.log", true));
+      log.set_min_level(LogLevel::ERROR);
+      RVLOG_DEBUG(log, "/fr/crash", "last words %d", 99);
+      std::abort();
+    }
+    int status = 0;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+    const auto lines = read_lines("rover_fr_crash.log");
+    assert(!lines.empty());
+    assert(lines.front().rfind("==== rover_logger flight recorder: SIGABRT", 0) == 0);
+    assert(contains(lines, "DEBUG [/fr/crash] last words 99"));
+  }
+
+  // 4) A stack overflow on another logging thread still dumps: each
+  //    recording thread gets its own alternate signal stack.
+  {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      Logger log(recorder_cfg("rover_fr_overflow.log", true));
+      std::thread t([&] {
+        RVLOG_INFO(log, "/fr/overflow", "about to recurse");
+        overflow(0);
+      });
+      t.join();
+      std::_Exit(0);
+    }
+    int status = 0;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+    const auto lines = read_lines("rover_fr_overflow.log");
+    assert(!lines.empty());
+    assert(lines.front().rfind("==== rover_logger flight recorder: SIGSEGV", 0) == 0);
+    assert(contains(lines, "INFO [/fr/overflow] about to recurse"));
+  }
+
+  std::cout << "OK: test_flight_recorder passed.\n";
+  return 0;
+}
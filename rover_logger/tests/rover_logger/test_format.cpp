@@ -0,0 +1,160 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rover_logger/api.hpp"
+#include "rover_logger/format.hpp"
+
+using namespace rover_logger;
+using format_detail::check_format;
+using format_detail::FormatError;
+
+// Formats like the RVLOG_*F macros do, into a fresh message text.
+#define FORMAT(...)                                                          \
+  [&] {                                                                      \
+    struct Fmt {                                                             \
+      static constexpr std::string_view str() {                              \
+        return ROVER_LOGGER_FIRST_(__VA_ARGS__, 0);                          \
+      }                                                                      \
+    };                                                                       \
+    return format_args<Fmt>(__VA_ARGS__);                                    \
+  }()
+
+template <class Fmt, class F, class... Args>
+static std::string format_args(const F&, const Args&... args) {
+  MessageText text;
+  format_to<Fmt>(text, args...);
+  return std::string(text.view());
+}
+
+// Shaped like an Eigen fixed-size vector, as far as Formatter cares.
+struct Vec3 {
+  using Scalar = double;
+  enum { IsVectorAtCompileTime = 1 };
+  double v[3];
+  long size() const { return 3; }
+  double coeff(long i) const { return v[i]; }
+};
+
+enum class Gear : std::uint8_t { Park = 0, Drive = 3 };
+
+class TextSink : public ILogSink {
+ public:
+  void write(const LogMessage& msg) override {
+    std::scoped_lock lk(m_);
+    lines_.emplace_back(msg.text.view());
+  }
+  std::vector<std::string> lines() {
+    std::scoped_lock lk(m_);
+    return lines_;
+  }
+
+ private:
+  std::mutex m_;
+  std::vector<std::string> lines_;
+};
+
+// 1) The checks run at compile time
+static_assert(check_format<int, double>("x={} y={:.2f}") == FormatError::None);
+static_assert(check_format<>("{{}} only braces") == FormatError::None);
+static_assert(check_format<int>("x={") == FormatError::UnmatchedBrace);
+static_assert(check_format<int>("x=}{}") == FormatError::UnmatchedBrace);
+static_assert(check_format<int>("{0}") == FormatError::PositionalField);
+static_assert(check_format<int>("{:10.}") == FormatError::BadSpec);
+static_assert(check_format<int>("{:1000}") == FormatError::BadSpec);
+static_assert(check_format<int, int>("{}") == FormatError::TooManyArgs);
+static_assert(check_format<int>("{} {}") == FormatError::TooFewArgs);
+static_assert(check_format<std::string>("{:x}") == FormatError::SpecTypeMismatch);
+static_assert(check_format<int>("{:.2}") == FormatError::SpecTypeMismatch);
+static_assert(check_format<double>("{:#x}") == FormatError::SpecTypeMismatch);
+static_assert(check_format<std::vector<int>>("{}") == FormatError::UnsupportedType);
+static_assert(check_format<Vec3>("{:.1f}") == FormatError::None);
+static_assert(check_format<std::chrono::milliseconds>("{:x}") == FormatError::None);
+static_assert(check_format<std::chrono::duration<double>>("{:x}") ==
+              FormatError::SpecTypeMismatch);
+
+int main() {
+  // 2) Integers, floats, and the spec mini-language
+  assert(FORMAT("x={} y={} z={}", -42, 7u,
+                std::numeric_limits<std::int64_t>::min()) ==
+         "x=-42 y=7 z=-9223372036854775808");
+  assert(FORMAT("{:x} {:#X} {:#o} {:#b} {:+d}", 255, 255u, 8, 5, 3) ==
+         "ff 0XFF 010 0b101 +3");
+  assert(FORMAT("[{:5}] [{:<5}] [{:^5}] [{:*>6}] [{:05}] [{:#06x}]", 42, 42, 42, 42,
+                -42, 255) == "[   42] [42   ] [ 42  ] [****42] [-0042] [0x00ff]");
+  assert(FORMAT("{} {} {}", 0.1, 1.5f, 1e20) == "0.1 1.5 1e+20");
+  assert(FORMAT("{:.2f} {:8.3f} {:+.1e} {:.3} {:G}", 3.14159, -2.5, 12345.0, 2.0 / 3,
+                1e-10) == "3.14   -2.500 +1.2e+04 0.667 1E-10");
+  assert(FORMAT("{:07.2f}", -1.5) == "-001.50");
+  assert(FORMAT("{} {}", std::numeric_limits<double>::infinity(), -0.0) == "inf -0");
+  assert(FORMAT("{}", std::numeric_limits<std::uint64_t>::max()) ==
+         "18446744073709551615");
+
+  // 3) Strings, chars, bools, pointers, enums, escapes
+  const std::string name = "lidar";
+  const char* null_str = nullptr;
+  assert(FORMAT("{} {} {} {} {}", "lit", name, std::string_view("sv"), 'c', true) ==
+         "lit lidar sv c true");
+  assert(FORMAT("[{:>8}] [{:.3}] [{:-^9}] {}", name, name, false, null_str) ==
+         "[   lidar] [lid] [--false--] (null)");
+  assert(FORMAT("{} {}", reinterpret_cast<const void*>(0x1f0), nullptr) ==
+         "0x1f0 0x0");
+  assert(FORMAT("gear={}", Gear::Drive) == "gear=3");
+  assert(FORMAT("{{{}}} }}{{", 1) == "{1} }{");
+  assert(FORMAT("no fields") == "no fields");
+  assert(FORMAT("{}", "") == "");
+
+  // 4) Durations and vectors
+  using namespace std::chrono_literals;
+  assert(FORMAT("{} {} {} {} {}", 250ms, 3s, 15us, 7ns, 2min) ==
+         "250ms 3s 15us 7ns 2min");
+  using fps30 = std::chrono::duration<int, std::ratio<1, 30>>;
+  using ms_f = std::chrono::duration<double, std::milli>;
+  assert(FORMAT("{:.1f}", ms_f(1.25)) == "1.2ms");
+  assert(FORMAT("{}", fps30(4)) == "4[1/30]s");
+  const Vec3 p{{1.0, -0.5, 2.25}};
+  assert(FORMAT("p={}", p) == "p=[1, -0.5, 2.25]");
+  assert(FORMAT("p={:.2f}", p) == "p=[1.00, -0.50, 2.25]");
+
+  // 5) Long output spills past the inline buffer and keeps every byte
+  {
+    const std::string chunk(100, 'a');
+    const std::string out =
+        FORMAT("{}|{}|{}|{:>250}|{}", chunk, chunk, chunk, 'z', 1);
+    assert(out.size() == 3 * 100 + 3 + 250 + 2);
+    assert(out.compare(0, 101, chunk + "|") == 0);
+    assert(out.substr(out.size() - 3) == "z|1");
+  }
+
+  // 6) Through the logger
+  {
+    Logger log(1024);
+    auto sink = std::make_shared<TextSink>();
+    log.add_sink(sink);
+    static const ModuleHandle kDrive{"/fmt/drive"};
+    RVLOG_INFOF(log, kDrive, "speed={:.2f} m/s after {}", 1.5, 20ms);
+    RVLOG_WARNF(log, "/fmt/arm", "joint {} at {}", 3, p);
+    RVLOG_DEBUGF(log, "/fmt/arm", "plain");
+    log.set_min_level(LogLevel::WARN);
+    int evaluated = 0;
+    RVLOG_INFOF(log, kDrive, "never {}", ++evaluated);
+    assert(evaluated == 0);
+    for (int i = 0; i < 2000 && log.processed_total() < 3; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto lines = sink->lines();
+    assert(lines.size() == 3);
+    assert(lines[0] == "speed=1.50 m/s after 20ms");
+    assert(lines[1] == "joint 3 at [1, -0.5, 2.25]");
+    assert(lines[2] == "plain");
+  }
+
+  std::cout << "OK: test_format passed.\n";
+  return 0;
+}
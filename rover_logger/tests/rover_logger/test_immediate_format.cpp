@@ -0,0 +1,67 @@
+// The RVLOG_* macros with deferred formatting turned off: the same calls
+// that compile under the default must also format correctly on the caller.
+#define ROVER_LOGGER_DEFERRED_FORMAT 0
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "rover_logger/api.hpp"
+
+using namespace rover_logger;
+
+class TextSink : public ILogSink {
+ public:
+  void write(const LogMessage& msg) override {
+    std::scoped_lock lk(m_);
+    lines_.emplace_back(msg.text.view());
+  }
+  std::vector<std::string> lines() {
+    std::scoped_lock lk(m_);
+    return lines_;
+  }
+
+ private:
+  std::mutex m_;
+  std::vector<std::string> lines_;
+};
+
+enum class Gear : int { Park = 0, Drive = 3 };
+
+int main() {
+  Logger log(1024);
+  auto sink = std::make_shared<TextSink>();
+  log.add_sink(sink);
+
+  // 1) String-like arguments reach printf as C strings
+  const std::string name = "lidar";
+  const std::string_view view = std::string_view("front_camera").substr(0, 5);
+  static const ModuleHandle kDrive{"/imm/drive"};
+  RVLOG_INFO(log, "/imm/sensors", "%s %s %s", name, view, "lit");
+  RVLOG_WARN(log, kDrive, "gear=%d speed=%.1f", Gear::Drive, 2.5);
+  RVLOG_ERROR(log, std::string("/imm/arm"), "joint %d %s", 3,
+              std::string_view("stuck"));
+
+  // 2) The early-out still skips argument evaluation
+  log.set_min_level(LogLevel::WARN);
+  int evaluated = 0;
+  RVLOG_INFO(log, kDrive, "never %d", ++evaluated);
+  assert(evaluated == 0);
+
+  for (int i = 0; i < 2000 && log.processed_total() < 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  const auto lines = sink->lines();
+  assert(lines.size() == 3);
+  assert(lines[0] == "lidar front lit");
+  assert(lines[1] == "gear=3 speed=2.5");
+  assert(lines[2] == "joint 3 stuck");
+
+  std::cout << "OK: test_immediate_format passed.\n";
+  return 0;
+}
@@ -1,10 +1,37 @@
 #include <cassert>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include "rover_logger/json_formatter.hpp"
 
 using namespace rover_logger;
 
+// Byte-at-a-time reference for the vectorized escaper.
+static std::string reference_escape(const std::string& s) {
+  std::string out;
+  for (unsigned char c : s) {
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\b': out += "\\b"; break;
+      case '\f': out += "\\f"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if (c < 0x20) {
+          char buf[7];
+          std::snprintf(buf, sizeof(buf), "\\u%04X", c);
+          out += buf;
+        } else {
+          out.push_back(static_cast<char>(c));
+        }
+    }
+  }
+  return out;
+}
+
 // Utility: check that substrings appear in order (by position)
 static bool appears_in_order(const std::string& s,
                              const std::string& a,
@@ -56,6 +83,69 @@ int main() {
   // 5) Line is single-line (no raw newlines)
   assert(je.find('\n') == std::string::npos);
 
+  // 5b) Vectorized scanner: a special byte at every position of strings
+  //     spanning several 16/32-byte blocks, plus UTF-8 / 0x7F / 0x80+
+  //     bytes that must pass through untouched.
+  {
+    const char specials[] = {'"', '\\', '\n', '\x01', '\x1f', '\0'};
+    for (std::size_t len = 0; len <= 80; ++len) {
+      std::string base;
+      for (std::size_t i = 0; i < len; ++i)
+        base.push_back(static_cast<char>("ab\x7f\xc3\xa9 ~ \x80\xff"[i % 10]));
+      assert(json_escape(base) == reference_escape(base));
+      for (std::size_t pos = 0; pos < len; ++pos) {
+        for (char sp : specials) {
+          std::string s = base;
+          s[pos] = sp;
+          if (pos + 3 < len) s[pos + 3] = '"';
+          assert(json_escape(s) == reference_escape(s));
+        }
+      }
+    }
+    // Appends into the caller's buffer.
+    std::string out = "prefix:";
+    append_json_escaped(out, "say \"hi\"");
+    assert(out == "prefix:say \\\"hi\\\"");
+  }
+
+  // 6) Timestamp formats. 2021-03-04T05:06:07.123456789Z
+  {
+    using namespace std::chrono;
+    const LogMessage::clock::time_point tp{duration_cast<LogMessage::clock::duration>(
+        seconds(1614834367) + nanoseconds(123456789))};
+    auto fmt = [&](TimestampFormat f, LogMessage::clock::time_point t) {
+      TimestampFormatter tf(f);
+      std::string out;
+      tf.append(out, t);
+      return out;
+    };
+    assert(fmt(TimestampFormat::Iso8601Millis, tp) == "2021-03-04T05:06:07.123Z");
+    assert(fmt(TimestampFormat::Iso8601Micros, tp) == "2021-03-04T05:06:07.123456Z");
+    assert(fmt(TimestampFormat::Iso8601Nanos, tp) == "2021-03-04T05:06:07.123456789Z");
+    assert(fmt(TimestampFormat::EpochMillis, tp) == "1614834367123");
+    assert(fmt(TimestampFormat::EpochMicros, tp) == "1614834367123456");
+    assert(fmt(TimestampFormat::EpochNanos, tp) == "1614834367123456789");
+    assert(iso8601_utc_ms(tp) == "2021-03-04T05:06:07.123Z");
+
+    // The cached prefix is rebuilt when the second (or day) changes.
+    TimestampFormatter tf;
+    std::string a, b, c;
+    tf.append(a, tp);
+    tf.append(b, tp + milliseconds(900));
+    tf.append(c, tp + hours(24));
+    assert(a == "2021-03-04T05:06:07.123Z");
+    assert(b == "2021-03-04T05:06:08.023Z");
+    assert(c == "2021-03-05T05:06:07.123Z");
+
+    // Epoch timestamps are bare JSON numbers.
+    TimestampFormatter epoch(TimestampFormat::EpochMillis);
+    LogMessage em{LogLevel::INFO, "ts.test", "x"};
+    em.ts = tp;
+    std::string line;
+    append_json_line(line, em, epoch);
+    assert(line.rfind("{\"ts\":1614834367123,\"level\":\"INFO\"", 0) == 0);
+  }
+
   std::cout << "OK: test_json_formatter passed.\n";
   return 0;
 }
\ No newline at end of file
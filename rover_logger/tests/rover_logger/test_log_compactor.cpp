@@ -0,0 +1,99 @@
+#include <zlib.h>
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "rover_logger/file_rotation_adapter.hpp"
+#include "rover_logger/log_compactor.hpp"
+
+namespace fs = std::filesystem;
+using namespace rover_logger;
+
+static void remove_with_prefix(const std::string& prefix) {
+  for (auto& e : fs::directory_iterator(".")) {
+    if (e.path().filename().string().rfind(prefix, 0) == 0) fs::remove(e);
+  }
+}
+
+static std::vector<std::string> files_with_prefix(const std::string& prefix) {
+  std::vector<std::string> out;
+  for (auto& e : fs::directory_iterator(".")) {
+    auto n = e.path().filename().string();
+    if (n.rfind(prefix, 0) == 0) out.push_back(n);
+  }
+  return out;
+}
+
+static std::string gunzip(const std::string& path) {
+  gzFile f = gzopen(path.c_str(), "rb");
+  assert(f != nullptr);
+  std::string out;
+  char buf[4096];
+  for (int n; (n = gzread(f, buf, sizeof(buf))) > 0;) out.append(buf, n);
+  gzclose(f);
+  return out;
+}
+
+int main() {
+  // 1) Rotated files are gzipped; only the newest rotate_keep survive.
+  {
+    remove_with_prefix("rover_gz_");
+    FileRotationAdapterOptions opt;
+    opt.base_filename = "rover_gz";
+    opt.rotation_bytes = 400;
+    opt.format = AdaptFormat::Text;
+    opt.compress = true;
+    opt.rotate_keep = 2;
+    {
+      FileRotationAdapter adapter(opt);
+      for (int i = 0; i < 60; ++i) {
+        adapter.write(LogMessage{LogLevel::INFO, "gz",
+                                 "line-" + std::to_string(i) + std::string(40, 'z')});
+      }
+    }  // destruction drains the compactor
+
+    const auto files = files_with_prefix("rover_gz_");
+    std::size_t gz = 0, plain = 0;
+    for (const auto& n : files) {
+      if (n.size() > 3 && n.compare(n.size() - 3, 3, ".gz") == 0) {
+        ++gz;
+        const std::string text = gunzip(n);
+        assert(!text.empty() && text.find("[INFO] (gz) line-") == 0);
+      } else {
+        assert(n.find(".tmp") == std::string::npos);
+        ++plain;
+      }
+    }
+    assert(gz == 2);     // rotate_keep
+    assert(plain == 1);  // the live file stays uncompressed
+    remove_with_prefix("rover_gz_");
+  }
+
+  // 2) Retention without compression
+  {
+    remove_with_prefix("rover_keep_");
+    LogCompactorOptions copt;
+    copt.base_filename = "rover_keep";
+    copt.compress = false;
+    copt.keep = 1;
+    LogCompactor compactor(copt);
+    for (int i = 0; i < 4; ++i) {
+      fs::path p = "rover_keep_" + std::to_string(i) + ".log";
+      std::ofstream(p) << "x\n";
+    }
+    compactor.notify_rotated(2);  // index 3 is the live file
+    compactor.wait_idle();
+    assert(!fs::exists("rover_keep_0.log"));
+    assert(!fs::exists("rover_keep_1.log"));
+    assert(fs::exists("rover_keep_2.log"));
+    assert(fs::exists("rover_keep_3.log"));
+    remove_with_prefix("rover_keep_");
+  }
+
+  std::cout << "OK: test_log_compactor passed.\n";
+  return 0;
+}
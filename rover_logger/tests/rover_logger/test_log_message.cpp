@@ -1,6 +1,8 @@
 #include <cassert>
 #include <iostream>
+#include <string>
 #include <thread>
+#include <utility>
 #include "rover_logger/log_message.hpp"
 
 using namespace rover_logger;
@@ -23,6 +25,27 @@ int main() {
             << " (" << msg.module << ") "
             << msg.text << "\n";
 
+  // Fixed-size, cache-aligned record; module is an interned id
+  static_assert(alignof(LogMessage) == 64);
+  LogMessage same{LogLevel::WARN, "demo.module", "other"};
+  assert(same.module.id() == msg.module.id());
+  assert(!msg.text.spilled());
+
+  // Long text spills to an overflow block and survives copy and move
+  const std::string long_text(1000, 'z');
+  LogMessage big{LogLevel::ERROR, "demo.module", long_text};
+  assert(big.text.spilled());
+  assert(big.text == long_text);
+  LogMessage copy = big;
+  assert(copy.text == long_text && copy.text.data() != big.text.data());
+  LogMessage moved = std::move(copy);
+  assert(moved.text == long_text);
+  assert(copy.text.empty());
+
+  // Assigning short text back returns to inline storage
+  moved.text.assign("short");
+  assert(!moved.text.spilled() && moved.text == "short");
+
   std::cout << "OK: test_log_message passed.\n";
   return 0;
 }
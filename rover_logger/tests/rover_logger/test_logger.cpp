@@ -1,7 +1,11 @@
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "rover_logger/logger.hpp"
@@ -21,6 +25,96 @@ class CountingSink : public ILogSink {
   std::atomic<std::uint64_t> count_{0};
 };
 
+// Records timestamps in the order the worker delivers them.
+class OrderSink : public ILogSink {
+ public:
+  void write(const LogMessage& msg) override {
+    std::scoped_lock lk(m_);
+    ts_.push_back(msg.ts);
+  }
+  std::vector<LogMessage::clock::time_point> snapshot() {
+    std::scoped_lock lk(m_);
+    return ts_;
+  }
+
+ private:
+  std::mutex m_;
+  std::vector<LogMessage::clock::time_point> ts_;
+};
+
+// Blocks the worker inside write() until open() is called, so tests can
+// fill the queue deterministically.
+class GateSink : public ILogSink {
+ public:
+  void write(const LogMessage& msg) override {
+    std::unique_lock lk(m_);
+    levels_.push_back(msg.level);
+    entered_ = true;
+    cv_.notify_all();
+    cv_.wait(lk, [&] { return open_; });
+  }
+  void wait_entered() {
+    std::unique_lock lk(m_);
+    cv_.wait(lk, [&] { return entered_; });
+  }
+  void open() {
+    std::scoped_lock lk(m_);
+    open_ = true;
+    cv_.notify_all();
+  }
+  std::size_t delivered() {
+    std::scoped_lock lk(m_);
+    return levels_.size();
+  }
+  std::vector<LogLevel> levels() {
+    std::scoped_lock lk(m_);
+    return levels_;
+  }
+  // Messages delivered at each sync() call.
+  void sync() override {
+    std::scoped_lock lk(m_);
+    syncs_.push_back(levels_.size());
+  }
+  std::vector<std::size_t> syncs() {
+    std::scoped_lock lk(m_);
+    return syncs_;
+  }
+
+ private:
+  std::mutex m_;
+  std::condition_variable cv_;
+  bool entered_ = false;
+  bool open_ = false;
+  std::vector<LogLevel> levels_;
+  std::vector<std::size_t> syncs_;
+};
+
+// A logger with an 8-slot queue whose worker is parked in GateSink.
+struct StalledLogger {
+  explicit StalledLogger(OverflowPolicy policy, std::size_t block_ms = 10)
+      : log(make_cfg(policy, block_ms)), gate(std::make_shared<GateSink>()) {
+    log.add_sink(gate);
+    log.log(LogMessage{LogLevel::INFO, "overflow", "first"});
+    gate->wait_entered();
+  }
+  static LoggerConfig make_cfg(OverflowPolicy policy, std::size_t block_ms) {
+    LoggerConfig cfg;
+    cfg.max_queue = 8;
+    cfg.overflow = policy;
+    cfg.block_timeout_ms = block_ms;
+    return cfg;
+  }
+  void push(LogLevel lv, int n) {
+    for (int i = 0; i < n; ++i) log.log(LogMessage{lv, "overflow", "x"});
+  }
+  std::uint64_t drops(LogLevel lv) const {
+    return log.dropped_by_level()[static_cast<std::size_t>(lv)];
+  }
+
+  Logger log;
+  std::shared_ptr<GateSink> gate;
+};
+
 int main() {
   // Test 1: basic throughput with no drops expected (big queue)
   {
@@ -64,7 +158,8 @@ int main() {
     for (int p = 0; p < producers; ++p) {
       threads.emplace_back([&log, p]() {
         for (int i = 0; i < per; ++i) {
-          log.log(LogMessage{static_cast<LogLevel>(i % 6),
+          // No FATAL: it bypasses the queue and drains it (Test 9).
+          log.log(LogMessage{static_cast<LogLevel>(i % 5),
                              "mod" + std::to_string(p),
                              "spam#" + std::to_string(i)});
         }
@@ -105,6 +200,318 @@ int main() {
            0);  // large enough queue; no backpressure needed here
   }
 
+  // Test 4: per-thread producer queues keep every message (big queues),
+  // merge them in timestamp order, and roll drops up from each thread.
+  {
+    Logger log(1 << 14, QueueMode::PerThread);
+    auto sink = std::make_shared<OrderSink>();
+    log.add_sink(sink);
+    log.set_min_level(LogLevel::TRACE);
+    assert(log.queue_mode() == QueueMode::PerThread);
+
+    const int producers = 4;
+    const int per = 2000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+      threads.emplace_back([&log, p]() {
+        for (int i = 0; i < per; ++i) {
+          log.log(LogMessage{LogLevel::INFO, "mod" + std::to_string(p),
+                             "pt#" + std::to_string(i)});
+        }
+      });
+    }
+    for (auto& t : threads) t.join();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    assert(log.processed_total() ==
+           static_cast<std::uint64_t>(producers) * per);
+    assert(log.dropped_total() == 0);
+
+    // Each queue is FIFO and the merge always emits the oldest head, so
+    // ordering can only go backwards while a producer races the worker.
+    auto ts = sink->snapshot();
+    assert(ts.size() == static_cast<std::size_t>(producers) * per);
+    std::size_t inversions = 0;
+    for (std::size_t i = 1; i < ts.size(); ++i) {
+      if (ts[i] < ts[i - 1]) ++inversions;
+    }
+    assert(inversions < ts.size() / 2);
+  }
+  {
+    Logger log(16, QueueMode::PerThread);
+    auto sink = std::make_shared<CountingSink>();
+    log.add_sink(sink);
+    log.set_min_level(LogLevel::TRACE);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < 4; ++p) {
+      threads.emplace_back([&log]() {
+        for (int i = 0; i < 5000; ++i) {
+          log.log(LogMessage{LogLevel::INFO, "mod", "spam"});
+        }
+      });
+    }
+    for (auto& t : threads) t.join();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // Exited threads' queues are reaped, but their counters survive.
+    assert(log.dropped_total() > 0);
+    assert(log.processed_total() + log.dropped_total() == 4u * 5000u);
+    assert(sink->count() == log.processed_total());
+    assert(log.queue_size_peak() <= 16);
+  }
+
+  // Test 5: per-module levels, including a cached ModuleHandle, and
+  // reconfiguring while producers are logging.
+  {
+    Logger log(1 << 14);
+    auto sink = std::make_shared<CountingSink>();
+    log.add_sink(sink);
+    log.set_min_level(LogLevel::INFO);
+
+    const ModuleHandle nav{"/lvl/nav"};
+    log.set_module_level("/lvl/nav", LogLevel::DEBUG);
+    log.set_module_level("/lvl/drive", LogLevel::ERROR);
+    assert(log.should_log(LogLevel::DEBUG, nav));
+    assert(!log.should_log(LogLevel::TRACE, nav));
+    assert(!log.should_log(LogLevel::WARN, ModuleHandle{"/lvl/drive"}));
+    assert(log.should_log(LogLevel::INFO, ModuleHandle{"/lvl/other"}));
+
+    log.apply_module_config({{"/lvl/drive", LogLevel::DEBUG}});
+    assert(!log.should_log(LogLevel::DEBUG, nav));  // override removed
+    assert(log.should_log(LogLevel::DEBUG, ModuleHandle{"/lvl/drive"}));
+    log.clear_all_module_levels();
+    assert(!log.should_log(LogLevel::DEBUG, ModuleHandle{"/lvl/drive"}));
+
+    std::atomic<bool> stop{false};
+    std::thread reconfig([&] {
+      while (!stop.load()) {
+        log.set_module_level("/lvl/nav", LogLevel::TRACE);
+        log.apply_module_config({{"/lvl/nav", LogLevel::ERROR}});
+      }
+    });
+    std::uint64_t accepted = 0;
+    for (int i = 0; i < 20000; ++i) {
+      LogMessage m{LogLevel::WARN, nav.id(), "flip"};
+      if (log.should_log(m.level, nav)) {
+        log.submit(std::move(m));
+        ++accepted;
+      }
+    }
+    stop.store(true);
+    reconfig.join();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    assert(log.processed_total() + log.dropped_total() == accepted);
+    assert(sink->count() == log.processed_total());
+  }
+
+  // Test 6: hierarchical overrides, longest configured prefix wins
+  {
+    Logger log(64);
+    log.set_min_level(LogLevel::INFO);
+    log.apply_module_config({{"/h/vision", LogLevel::WARN},
+                             {"/h/vision/stereo", LogLevel::DEBUG}});
+
+    const ModuleHandle rectify{"/h/vision/stereo/rectify"};
+    const ModuleHandle mono{"/h/vision/mono"};
+    const ModuleHandle lookalike{"/h/visionary"};
+    assert(log.should_log(LogLevel::DEBUG, rectify));
+    assert(!log.should_log(LogLevel::TRACE, rectify));
+    assert(!log.should_log(LogLevel::INFO, mono));
+    assert(log.should_log(LogLevel::WARN, mono));
+    assert(log.should_log(LogLevel::INFO, lookalike));  // segment boundary
+
+    // Cached resolutions follow later changes.
+    log.clear_module_level("/h/vision/stereo");
+    assert(!log.should_log(LogLevel::DEBUG, rectify));
+    log.set_module_level("/h/vision", LogLevel::ERROR);
+    assert(!log.should_log(LogLevel::WARN, rectify));
+    log.set_min_level(LogLevel::TRACE);
+    log.clear_all_module_levels();
+    assert(log.should_log(LogLevel::TRACE, rectify));
+  }
+
+  // Test 7: overflow policies, with per-level drop counters
+  {
+    // Drop oldest (default): the evicted messages are the ones counted.
+    StalledLogger d(OverflowPolicy::DropOldest);
+    d.push(LogLevel::DEBUG, 8);
+    d.push(LogLevel::ERROR, 3);
+    assert(d.drops(LogLevel::DEBUG) == 3);
+    assert(d.drops(LogLevel::ERROR) == 0);
+    d.gate->open();
+  }
+  {
+    // Drop newest: the queue keeps the first 8, the rest are refused.
+    StalledLogger d(OverflowPolicy::DropNewest);
+    d.push(LogLevel::INFO, 8);
+    d.push(LogLevel::WARN, 4);
+    assert(d.drops(LogLevel::WARN) == 4);
+    assert(d.log.dropped_total() == 4);
+    d.gate->open();
+    while (d.log.processed_total() < 9) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    assert(d.gate->delivered() == 9);
+  }
+  {
+    // Block: waits for room up to the timeout, then drops the new message.
+    StalledLogger b(OverflowPolicy::Block, 100);
+    b.push(LogLevel::INFO, 8);
+    auto t0 = std::chrono::steady_clock::now();
+    b.push(LogLevel::INFO, 1);
+    assert(std::chrono::steady_clock::now() - t0 >= std::chrono::milliseconds(90));
+    assert(b.drops(LogLevel::INFO) == 1);
+
+    std::thread opener([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      b.gate->open();
+    });
+    b.push(LogLevel::INFO, 1);  // room appears within the timeout
+    opener.join();
+    assert(b.log.dropped_total() == 1);
+  }
+  {
+    // Level-aware: DEBUG refused from half full, INFO from 7/8 full, WARN
+    // takes the headroom and, with the queue full, waits like Block.
+    StalledLogger l(OverflowPolicy::LevelAware, 100);
+    l.push(LogLevel::DEBUG, 5);
+    assert(l.drops(LogLevel::DEBUG) == 1);
+    l.push(LogLevel::INFO, 4);
+    assert(l.drops(LogLevel::INFO) == 1);
+    l.push(LogLevel::WARN, 1);  // fills the last slot
+    assert(l.drops(LogLevel::WARN) == 0);
+
+    auto t0 = std::chrono::steady_clock::now();
+    l.push(LogLevel::WARN, 1);  // never waits forever on a stalled sink
+    assert(std::chrono::steady_clock::now() - t0 >= std::chrono::milliseconds(90));
+    assert(l.drops(LogLevel::WARN) == 1);
+
+    std::thread opener([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      l.gate->open();
+    });
+    l.push(LogLevel::ERROR, 2);
+    opener.join();
+    assert(l.drops(LogLevel::ERROR) == 0);
+    assert(l.log.dropped_total() == 3);
+  }
+
+  // Test 8: per-sink dispatch, a stalled sink does not hold up the others
+  {
+    LoggerConfig cfg;
+    cfg.max_queue = 256;
+    cfg.batch_max = 1;  // the stalled sink holds exactly one message
+    cfg.dispatch = DispatchMode::PerSink;
+    cfg.sink_queue = 100;
+    Logger log(cfg);
+    auto gate = std::make_shared<GateSink>();
+    auto fast = std::make_shared<CountingSink>();
+    log.add_sink(gate);
+    log.add_sink(fast);
+    assert(log.dispatch_mode() == DispatchMode::PerSink);
+
+    const std::uint64_t N = 100;
+    auto burst = [&] {
+      for (std::uint64_t i = 0; i < N; ++i) {
+        log.log(LogMessage{LogLevel::INFO, "fanout", "m"});
+      }
+    };
+    auto wait_fast = [&](std::uint64_t n) {
+      for (int i = 0; i < 5000 && fast->count() < n; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    };
+
+    burst();
+    gate->wait_entered();
+    wait_fast(N);
+    burst();  // the stalled sink's queue (99 queued) overflows now
+    wait_fast(2 * N);
+    assert(fast->count() == 2 * N);  // while gate is still closed
+    assert(log.processed_total() == 2 * N);
+    assert(log.dropped_total() == 0);
+
+    LoggerMetrics m = log.metrics_snapshot();
+    assert(m.sinks.size() == 2);
+    assert(m.sinks[0].dropped == N - 1);
+    assert(m.sinks[0].queue_peak == N);
+    assert(m.sinks[1].dropped == 0 && m.sinks[1].written == 2 * N);
+
+    gate->open();
+    for (int i = 0; i < 5000; ++i) {
+      m = log.metrics_snapshot();
+      if (m.sinks[0].written + m.sinks[0].dropped == 2 * N) break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(m.sinks[0].written == N + 1);
+    assert(m.sinks[0].queue_depth == 0);
+    assert(gate->delivered() == N + 1);
+  }
+
+  // Test 9: emergency path, FATAL is written and synced before log()
+  // returns, after what was queued, and never dropped
+  const std::pair<QueueMode, DispatchMode> modes[] = {
+      {QueueMode::Shared, DispatchMode::Inline},
+      {QueueMode::PerThread, DispatchMode::Inline},
+      {QueueMode::Shared, DispatchMode::PerSink}};
+  for (const auto& [queue_mode, dispatch] : modes) {
+    LoggerConfig cfg;
+    cfg.max_queue = 8;
+    cfg.batch_max = 1;
+    cfg.queue_mode = queue_mode;
+    cfg.dispatch = dispatch;
+    cfg.sink_queue = 64;
+    Logger log(cfg);
+    auto gate = std::make_shared<GateSink>();
+    log.add_sink(gate);
+    assert(log.emergency_level() == LogLevel::FATAL);
+
+    log.log(LogMessage{LogLevel::INFO, "emergency", "first"});
+    gate->wait_entered();
+    for (int i = 0; i < 20; ++i) {
+      log.log(LogMessage{LogLevel::ERROR, "emergency", "queued"});
+    }
+    // Waits for the stalled write, so it runs on its own thread.
+    std::atomic<bool> returned{false};
+    std::thread fatal([&] {
+      log.log(LogMessage{LogLevel::FATAL, "emergency", "fatal"});
+      returned.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    assert(!returned.load());
+    gate->open();
+    fatal.join();
+
+    // One queued message may be in the worker's (or, under PerSink, the
+    // sink thread's) hands; the rest was written before the FATAL, which
+    // was synced.
+    const auto levels = gate->levels();
+    const auto fatal_at = static_cast<std::size_t>(
+        std::find(levels.begin(), levels.end(), LogLevel::FATAL) -
+        levels.begin());
+    assert(fatal_at < levels.size());
+    const std::size_t total = 1 + 20 - log.dropped_total() + 1;
+    assert(fatal_at + 2 >= total);
+    assert(gate->syncs() == std::vector<std::size_t>{fatal_at + 1});
+    assert(log.dropped_by_level()[static_cast<std::size_t>(LogLevel::FATAL)] == 0);
+  }
+  {
+    // ERROR too, when configured; below it messages stay on the queue.
+    LoggerConfig cfg;
+    cfg.emergency_level = LogLevel::ERROR;
+    Logger log(cfg);
+    auto gate = std::make_shared<GateSink>();
+    gate->open();
+    log.add_sink(gate);
+    log.log(LogMessage{LogLevel::ERROR, "emergency", "error"});
+    assert(gate->delivered() == 1 && gate->syncs().size() == 1);
+    assert(log.processed_total() == 1);
+    log.log(LogMessage{LogLevel::WARN, "emergency", "warn"});
+    for (int i = 0; i < 2000 && log.processed_total() < 2; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(gate->delivered() == 2 && gate->syncs().size() == 1);
+  }
+
   std::cout << "OK: test_logger passed.\n";
   return 0;
 }
@@ -0,0 +1,132 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "rover_logger/logger.hpp"
+#include "rover_logger/metrics.hpp"
+
+using namespace rover_logger;
+
+// Sleeps a little per batch so write latency is visible.
+class SlowSink : public ILogSink {
+ public:
+  void write(const LogMessage&) override {}
+  void write_batch(const LogMessage*, std::size_t) override {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  const char* name() const override { return "slow"; }
+};
+
+class NullSink : public ILogSink {
+ public:
+  void write(const LogMessage&) override {}
+};
+
+static bool within(std::uint64_t got, std::uint64_t want, double tol) {
+  const double d = static_cast<double>(got) - static_cast<double>(want);
+  return (d < 0 ? -d : d) <= tol * static_cast<double>(want);
+}
+
+int main() {
+  // 1) Histogram buckets and percentiles.
+  {
+    for (std::uint64_t v : {0ull, 1ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull,
+                            (1ull << 40) + 5, ~0ull}) {
+      const std::size_t idx = Histogram::bucket_index(v);
+      assert(idx < Histogram::kBuckets);
+      assert(Histogram::bucket_upper(idx) >= v);
+      if (idx > 0) assert(Histogram::bucket_upper(idx - 1) < v);
+    }
+
+    Histogram h;
+    assert(h.summary().count == 0);
+    for (std::uint64_t v = 1; v <= 100000; ++v) h.record(v);
+    const HistogramSummary s = h.summary();
+    assert(s.count == 100000);
+    assert(s.max == 100000);
+    assert(within(static_cast<std::uint64_t>(s.mean), 50000, 0.01));
+    assert(within(s.p50, 50000, 0.07));
+    assert(within(s.p90, 90000, 0.07));
+    assert(within(s.p99, 99000, 0.07));
+    assert(s.p999 <= s.max && within(s.p999, 99900, 0.07));
+  }
+
+  // 2) Logger snapshot: modules, sinks, batches, queue.
+  {
+    Logger logger(1024);
+    logger.add_sink(std::make_shared<SlowSink>());
+    logger.add_sink(std::make_shared<NullSink>());
+
+    for (int i = 0; i < 300; ++i) {
+      logger.log(LogMessage{LogLevel::INFO, "/metrics/flood", "0123456789"});
+    }
+    for (int i = 0; i < 20; ++i) {
+      logger.log(LogMessage{LogLevel::WARN, "/metrics/quiet", "abc"});
+    }
+    while (logger.processed_total() + logger.dropped_total() < 320) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const LoggerMetrics m = logger.metrics_snapshot();
+    assert(m.processed_total == 320);
+    assert(m.dropped_total == 0);
+    assert(m.queue_depth == 0);
+    assert(m.queue_capacity == 1024);
+    assert(m.queue_peak >= 1);
+    assert(m.interval_sec > 0);
+
+    assert(m.sinks.size() == 2);
+    assert(m.sinks[0].name == "slow");
+    assert(m.sinks[1].name == "sink");
+    assert(m.sinks[0].write_ns.count == m.batch_size.count);
+    assert(m.sinks[0].write_ns.p50 >= 150000);  // ~200 us per batch
+    assert(m.sinks[1].write_ns.p50 < m.sinks[0].write_ns.p50);
+
+    // Every message lands in exactly one batch; one in 8 is sampled.
+    assert(m.batch_size.count >= 1);
+    assert(m.batch_size.mean * static_cast<double>(m.batch_size.count) > 319.0);
+    assert(m.enqueue_to_sink_ns.count == 40);
+
+    // Busiest module first, with exact totals.
+    assert(m.modules.size() >= 2);
+    assert(m.modules[0].module == "/metrics/flood");
+    assert(m.modules[0].messages == 300);
+    assert(m.modules[0].bytes == 3000);
+    assert(m.modules[0].messages_per_sec > 0);
+    bool quiet = false;
+    for (const auto& mod : m.modules) {
+      if (mod.module == "/metrics/quiet") {
+        quiet = true;
+        assert(mod.messages == 20 && mod.bytes == 60);
+      }
+    }
+    assert(quiet);
+
+    // Rates are per interval: nothing new since the last snapshot.
+    const LoggerMetrics again = logger.metrics_snapshot();
+    assert(again.modules[0].messages_per_sec == 0);
+    assert(again.modules[0].messages == 300 || again.modules[1].messages == 300);
+
+    const std::string js = metrics_to_json(m);
+    assert(js.front() == '{' && js.back() == '}');
+    assert(js.find("\"processed_total\":320") != std::string::npos);
+    assert(js.find("\"module\":\"/metrics/flood\",\"messages\":300") !=
+           std::string::npos);
+    assert(js.find("\"name\":\"slow\"") != std::string::npos);
+
+    // Counters stay exact past the double mantissa.
+    LoggerMetrics huge = m;
+    huge.processed_total = 18446744073709551615ull;
+    huge.dropped_total = 12345678901234ull;
+    const std::string big = metrics_to_json(huge);
+    assert(big.find("\"processed_total\":18446744073709551615,") !=
+           std::string::npos);
+    assert(big.find("\"dropped_total\":12345678901234,") != std::string::npos);
+  }
+
+  std::cout << "OK: test_metrics passed.\n";
+  return 0;
+}
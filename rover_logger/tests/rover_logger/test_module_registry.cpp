@@ -0,0 +1,47 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rover_logger/module_registry.hpp"
+
+using namespace rover_logger;
+
+int main() {
+  auto& reg = ModuleRegistry::instance();
+
+  // 1) Interning is stable and round-trips through name()
+  const ModuleId drive = reg.intern("/drive");
+  assert(drive != ModuleRegistry::kUnknown);
+  assert(reg.intern(std::string("/drive")) == drive);
+  assert(reg.name(drive) == "/drive");
+  assert(reg.name(ModuleRegistry::kUnknown) == "?");
+
+  // find() never inserts
+  const std::size_t before = reg.size();
+  assert(reg.find("/drive") == drive);
+  assert(reg.find("/never/interned") == ModuleRegistry::kUnknown);
+  assert(reg.size() == before);
+
+  // 2) Concurrent interning of the same names yields one id per name
+  const int threads = 8;
+  const int names = 200;
+  std::vector<std::vector<ModuleId>> seen(threads);
+  std::vector<std::thread> ts;
+  for (int t = 0; t < threads; ++t) {
+    ts.emplace_back([&, t] {
+      for (int i = 0; i < names; ++i) {
+        seen[t].push_back(reg.intern("/race/" + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& th : ts) th.join();
+  for (int t = 1; t < threads; ++t) assert(seen[t] == seen[0]);
+  for (int i = 0; i < names; ++i) {
+    assert(reg.name(seen[0][i]) == "/race/" + std::to_string(i));
+  }
+
+  std::cout << "OK: test_module_registry passed.\n";
+  return 0;
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rover_logger/api.hpp"
+#include "rover_logger/logger.hpp"
+#include "rover_logger/rate_limiter.hpp"
+
+using namespace rover_logger;
+
+// Keeps the text of every message it is given.
+class TextSink : public ILogSink {
+ public:
+  void write(const LogMessage& msg) override {
+    std::scoped_lock lk(m_);
+    lines_.emplace_back(msg.text.view());
+  }
+  std::vector<std::string> lines() {
+    std::scoped_lock lk(m_);
+    return lines_;
+  }
+  std::size_t count(const std::string& text) {
+    const auto l = lines();
+    return static_cast<std::size_t>(std::count(l.begin(), l.end(), text));
+  }
+
+ private:
+  std::mutex m_;
+  std::vector<std::string> lines_;
+};
+
+static void wait_processed(Logger& log, std::uint64_t n) {
+  for (int i = 0; i < 2000 && log.processed_total() < n; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  assert(log.processed_total() == n);
+}
+
+int main() {
+  // 1) Token bucket: burst at once, then one per interval
+  {
+    TokenBucket b(10.0, 3);
+    const std::int64_t t0 = 1'000'000'000;
+    assert(b.try_take(t0) && b.try_take(t0) && b.try_take(t0));
+    assert(!b.try_take(t0));
+    assert(!b.try_take(t0 + 50'000'000));
+    assert(b.try_take(t0 + 100'000'000));
+    assert(!b.try_take(t0 + 100'000'000));
+    // Idle time refills up to the burst, not beyond.
+    const std::int64_t t1 = t0 + 10'000'000'000;
+    assert(b.try_take(t1) && b.try_take(t1) && b.try_take(t1));
+    assert(!b.try_take(t1));
+  }
+
+  // 2) Call-site limiter: 1 in n, and suppressed counts reported at most
+  //    once a second
+  {
+    CallSiteLimiter site;
+    std::vector<bool> got;
+    for (int i = 0; i < 9; ++i) got.push_back(site.every_n(4));
+    assert((got == std::vector<bool>{true, false, false, false, true, false,
+                                     false, false, true}));
+    assert(site.take_suppressed() == 6);
+    assert(!site.every_n(4));
+    assert(site.take_suppressed() == 0);  // reported less than 1 s ago
+
+    CallSiteLimiter timed;
+    assert(timed.every(0.05));
+    assert(!timed.every(0.05));
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    assert(timed.every(0.05));
+  }
+
+  // 3) Module sampling: 1 in 10 per call site, shared by sub-modules
+  {
+    Logger log(1024);
+    auto sink = std::make_shared<TextSink>();
+    log.add_sink(sink);
+    ModuleLimit lim;
+    lim.sample = 10;
+    log.set_module_limit("/rl/vision", lim);
+
+    for (int i = 0; i < 100; ++i) {
+      RVLOG_INFO(log, "/rl/vision/cam", "frame %d", i);
+    }
+    log.log(LogMessage{LogLevel::INFO, "/rl/other", "unlimited"});
+    wait_processed(log, 10 + 1 + 1);
+    assert(log.suppressed_total() == 90);
+    assert(sink->count("frame 0") == 1 && sink->count("frame 90") == 1);
+    assert(sink->count("frame 1") == 0);
+    // Reported after frame 10; later reports wait out the second.
+    assert(sink->count("suppressed 9 similar messages") == 1);
+    assert(sink->lines()[2] == "suppressed 9 similar messages");
+
+    // Removing the limit lets everything through again.
+    log.clear_module_limit("/rl/vision");
+    RVLOG_INFO(log, "/rl/vision/cam", "frame %d", 100);
+    RVLOG_INFO(log, "/rl/vision/cam", "frame %d", 101);
+    wait_processed(log, 14);
+  }
+
+  // 4) Module token bucket, and messages at the emergency level are
+  //    never held back
+  {
+    Logger log(1024);
+    auto sink = std::make_shared<TextSink>();
+    log.add_sink(sink);
+    ModuleLimit lim;
+    lim.rate = 20;
+    lim.burst = 5;
+    log.apply_module_limits({{"/rl/drive", lim}, {"/rl/off", ModuleLimit{}}});
+
+    for (int i = 0; i < 50; ++i) {
+      log.log(LogMessage{LogLevel::WARN, "/rl/drive", "stall"});
+    }
+    log.log(LogMessage{LogLevel::FATAL, "/rl/drive", "fatal"});
+    for (int i = 0; i < 5; ++i) {
+      log.log(LogMessage{LogLevel::WARN, "/rl/off", "off"});
+    }
+    wait_processed(log, 5 + 1 + 5);
+    assert(log.suppressed_total() == 45);
+    assert(sink->count("fatal") == 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    log.log(LogMessage{LogLevel::WARN, "/rl/drive", "recovered"});
+    wait_processed(log, 13);
+    const auto lines = sink->lines();
+    assert(lines[11] == "recovered");
+    assert(lines[12] == "suppressed 45 similar messages");
+    assert(log.metrics_snapshot().suppressed_total == 45);
+  }
+
+  // 5) Per-statement variants of the macros
+  {
+    Logger log(1024);
+    auto sink = std::make_shared<TextSink>();
+    log.add_sink(sink);
+    for (int i = 0; i < 20; ++i) {
+      RVLOG_INFO_EVERY_N(log, "/rl/macro", 5, "tick %d", i);
+      RVLOG_WARN_EVERY_SEC(log, "/rl/macro", 10.0, "slow %d", i);
+    }
+    wait_processed(log, 4 + 1 + 1);
+    assert(sink->count("tick 0") == 1 && sink->count("tick 15") == 1);
+    assert(sink->count("suppressed 4 similar messages") == 1);
+    assert(sink->count("slow 0") == 1);
+    assert(log.suppressed_total() == 0);  // call-site limits are separate
+
+    // Below the level filter nothing is counted or evaluated.
+    log.set_min_level(LogLevel::WARN);
+    int evaluated = 0;
+    for (int i = 0; i < 10; ++i) {
+      RVLOG_DEBUG_EVERY_N(log, "/rl/macro", 2, "n=%d", ++evaluated);
+    }
+    assert(evaluated == 0);
+  }
+
+  std::cout << "OK: test_rate_limiter passed.\n";
+  return 0;
+}
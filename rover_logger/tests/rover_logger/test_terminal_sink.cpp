@@ -1,4 +1,11 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <vector>
 #include "rover_logger/logger.hpp"
 #include "rover_logger/terminal_sink.hpp"
 
@@ -20,6 +27,35 @@ int main() {
   // give worker a moment
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
+  // Non-TTY output: colour is requested but no escapes are written, and a
+  // batch comes out as whole lines in order.
+  {
+    const char* path = "build/terminal_sink.out";
+    const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+    {
+      TerminalSink file_term(true, fd);
+      assert(!file_term.colorized());
+      std::vector<LogMessage> msgs;
+      msgs.emplace_back(LogLevel::WARN, "/drive", "low battery");
+      msgs.emplace_back(LogLevel::INFO, "/nav", "waypoint 3");
+      file_term.write_batch(msgs.data(), msgs.size());
+      file_term.write(LogMessage{LogLevel::ERROR, "/vision", "no frames"});
+    }
+    ::close(fd);
+
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string l; std::getline(in, l);) lines.push_back(l);
+    assert(lines.size() == 3);
+    for (const auto& l : lines) assert(l.find('\033') == std::string::npos);
+    // "YYYY-MM-DD HH:MM:SS.mmm " prefix
+    assert(lines[0].size() > 24 && lines[0][10] == ' ' && lines[0][19] == '.');
+    assert(lines[0].substr(24) == "[WARN] (/drive) low battery");
+    assert(lines[1].substr(24) == "[INFO] (/nav) waypoint 3");
+    assert(lines[2].substr(24) == "[ERROR] (/vision) no frames");
+  }
+
   std::cout << "OK: test_terminal_sink passed.\n";
   return 0;
 }